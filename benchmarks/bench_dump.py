@@ -0,0 +1,49 @@
+"""
+Time Json.to_json on float-heavy documents: canada.json of nativejson-benchmark
+(https://github.com/miloyip/nativejson-benchmark/tree/master/data) and arrays of random doubles,
+with json.dumps of the same values as a reference:
+
+    python3 benchmarks/bench_dump.py [path/to/nativejson-benchmark/data]
+
+Without a directory, canada.json is replaced by a generated document of the same shape.
+"""
+
+from __future__ import annotations
+
+import json
+import math
+import random
+import struct
+import sys
+import timeit
+from pathlib import Path
+
+import pybind11_jsoncons as m
+
+
+def generate() -> dict[str, object]:
+    rng = random.Random(42)
+    coordinates = [[rng.uniform(-100, 100), rng.uniform(-50, 50)] for _ in range(110000)]
+    canada = {"type": "FeatureCollection", "features": [{"geometry": {"coordinates": [coordinates]}}]}
+    bit_patterns = []
+    while len(bit_patterns) < 200000:
+        (x,) = struct.unpack("<d", rng.getrandbits(64).to_bytes(8, "little"))
+        if math.isfinite(x):
+            bit_patterns.append(x)
+    short_decimals = [round(rng.uniform(-1000, 1000), rng.randrange(1, 6)) for _ in range(200000)]
+    return {"canada.json": canada, "random bits": bit_patterns, "short decimals": short_decimals}
+
+
+def main() -> None:
+    docs = generate()
+    if len(sys.argv) > 1:
+        docs["canada.json"] = json.loads((Path(sys.argv[1]) / "canada.json").read_bytes())
+    for name, doc in docs.items():
+        value = m.Json().from_python(doc)
+        dump = min(timeit.repeat(value.to_json, number=1, repeat=10))
+        dumps = min(timeit.repeat(lambda doc=doc: json.dumps(doc, separators=(",", ":")), number=1, repeat=10))
+        print(f"{name:16} to_json {dump * 1e3:8.2f} ms  json.dumps {dumps * 1e3:8.2f} ms")
+
+
+if __name__ == "__main__":
+    main()
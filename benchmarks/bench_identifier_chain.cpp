@@ -0,0 +1,90 @@
+// Time the JMESPath expression a.b.c.d.e on ojson documents whose objects have 10 to 1000
+// members at every level, with the wanted member last. Next to it, the same five lookups are
+// timed the way identifier_selector used to do them, contains() and then at(), and with one
+// find_value() per level as it does now:
+//
+//     make bench_identifier_chain
+//
+// The driver builds with JSONCONS_ORDER_PRESERVING_INDEX_THRESHOLD=32, as the Python module does.
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jmespath/jmespath.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+using jsoncons::ojson;
+
+const std::vector<std::string> path = {"a", "b", "c", "d", "e"};
+
+ojson make_doc(std::size_t width)
+{
+    ojson value(42);
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        ojson object(jsoncons::json_object_arg);
+        for (std::size_t i = 0; i + 1 < width; ++i) {
+            object.try_emplace(*it + "_sibling_" + std::to_string(i), static_cast<int64_t>(i));
+        }
+        object.try_emplace(*it, std::move(value));
+        value = std::move(object);
+    }
+    return value;
+}
+
+template <typename F>
+double best_ns(std::size_t iterations, F f)
+{
+    double best = 1e30;
+    for (int repeat = 0; repeat < 5; ++repeat) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            f();
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = (std::min)(best, elapsed.count() / static_cast<double>(iterations));
+    }
+    return best;
+}
+
+} // namespace
+
+int main()
+{
+    const auto expr = jsoncons::jmespath::make_expression<ojson>("a.b.c.d.e");
+    std::printf("%8s %16s %20s %20s\n", "members", "a.b.c.d.e ns", "contains+at ns", "find_value ns");
+    int64_t sum = 0;
+    for (std::size_t width : {10, 100, 1000}) {
+        const ojson doc = make_doc(width);
+        const std::size_t iterations = 2000000 / width + 1000;
+        double evaluate_ns = best_ns(iterations, [&]() {
+            sum += expr.evaluate(doc).as<int64_t>();
+        });
+        double before_ns = best_ns(iterations, [&]() {
+            const ojson* value = &doc;
+            for (const auto& key : path) {
+                value = value->is_object() && value->contains(key) ? &value->at(key) : nullptr;
+                if (value == nullptr) {
+                    return;
+                }
+            }
+            sum += value->as<int64_t>();
+        });
+        double after_ns = best_ns(iterations, [&]() {
+            const ojson* value = &doc;
+            for (const auto& key : path) {
+                value = value->find_value(key);
+                if (value == nullptr) {
+                    return;
+                }
+            }
+            sum += value->as<int64_t>();
+        });
+        std::printf("%8zu %16.1f %20.1f %20.1f\n", width, evaluate_ns, before_ns, after_ns);
+    }
+    return sum == 0 ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+// Compare the lowered JMESPath token programs (a plain loop for chains of fields, an inline
+// operand stack otherwise) with the evaluate_tokens interpreter. Lowering is a compile time
+// setting, so the driver is built twice:
+//
+//     make bench_jmespath_programs
+//     make bench_jmespath_programs BENCH_ARGS=path/to/jmespath.test/tests
+//
+// With a directory, every expression of the compliance tests in it
+// (https://github.com/jmespath/jmespath.test/tree/master/tests) that compiles is evaluated on its
+// own document, and the time is summed per file. Without one, expressions of the same kinds are
+// evaluated on a generated document of 1000 people.
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jmespath/jmespath.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using jsoncons::ojson;
+
+struct bench_case
+{
+    ojson doc;
+    jsoncons::jmespath::jmespath_expression<ojson> expr;
+};
+
+// Time per evaluation of all cases, in microseconds
+double best_us(const std::vector<bench_case>& cases, std::size_t iterations, std::size_t& sink)
+{
+    double best = 1e30;
+    for (int repeat = 0; repeat < 5; ++repeat) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            for (const auto& c : cases) {
+                std::error_code ec;
+                sink += c.expr.evaluate(c.doc, ec).size();
+            }
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        best = (std::min)(best, elapsed.count() / static_cast<double>(iterations));
+    }
+    return best;
+}
+
+std::vector<std::pair<std::string, std::vector<bench_case>>> load_compliance(const std::filesystem::path& dir)
+{
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().extension() == ".json") {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    std::vector<std::pair<std::string, std::vector<bench_case>>> suites;
+    for (const auto& file : files) {
+        std::ifstream is(file);
+        ojson groups = ojson::parse(is);
+        std::vector<bench_case> cases;
+        for (const auto& group : groups.array_range()) {
+            for (const auto& test : group["cases"].array_range()) {
+                if (test.contains("error")) {
+                    continue;
+                }
+                std::error_code ec;
+                auto expr = jsoncons::jmespath::make_expression<ojson>(test["expression"].as_string_view(), ec);
+                if (!ec) {
+                    cases.push_back(bench_case{group["given"], std::move(expr)});
+                }
+            }
+        }
+        suites.emplace_back(file.filename().string(), std::move(cases));
+    }
+    return suites;
+}
+
+std::vector<std::pair<std::string, std::vector<bench_case>>> generate()
+{
+    ojson people(jsoncons::json_array_arg);
+    for (int i = 0; i < 1000; ++i) {
+        ojson person(jsoncons::json_object_arg);
+        person.try_emplace("name", "person " + std::to_string(i));
+        person.try_emplace("age", i % 90);
+        person.try_emplace("address", ojson::parse(R"({"city": "Seattle", "state": {"code": "WA"}})"));
+        person.try_emplace("tags", ojson::parse(i % 3 ? R"(["a", "b"])" : "[]"));
+        people.push_back(std::move(person));
+    }
+    ojson doc(jsoncons::json_object_arg);
+    doc.try_emplace("people", std::move(people));
+    doc.try_emplace("meta", ojson::parse(R"({"a": {"b": {"c": {"d": 1}}}, "n": 5})"));
+
+    const std::vector<std::pair<std::string, std::vector<std::string>>> kinds = {
+        {"identifiers", {"meta.a.b.c.d", "meta.n", "meta.missing.x"}},
+        {"projections", {"people[*].name", "people[*].address.state.code", "people[].tags[]"}},
+        {"filters", {"people[?age > `20`].name", "people[?age > `20` && tags[0] == 'a'].name",
+                     "people[?address.state.code == 'WA'] | length(@)"}},
+        {"functions", {"length(people)", "max_by(people, &age).name", "sort_by(people, &age)[0].name",
+                       "sum(people[*].age)"}},
+        {"multiselect", {"people[*].[name, age]", "people[*].{n: name, c: address.city}"}},
+        {"slices", {"people[::10].name", "people[-5:].age"}},
+        {"let", {"let $x = meta.n in people[?age < $x].name"}},
+    };
+    std::vector<std::pair<std::string, std::vector<bench_case>>> suites;
+    for (const auto& kind : kinds) {
+        std::vector<bench_case> cases;
+        for (const auto& text : kind.second) {
+            cases.push_back(bench_case{doc, jsoncons::jmespath::make_expression<ojson>(text)});
+        }
+        suites.emplace_back(kind.first, std::move(cases));
+    }
+    return suites;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto suites = argc > 1 ? load_compliance(argv[1]) : generate();
+    std::printf("JSONCONS_JMESPATH_LOWER_PROGRAMS=%d\n", JSONCONS_JMESPATH_LOWER_PROGRAMS);
+    std::size_t sink = 0;
+    double total = 0;
+    for (const auto& suite : suites) {
+        if (suite.second.empty()) {
+            continue;
+        }
+        const std::size_t iterations = argc > 1 ? 2000 : 20;
+        double us = best_us(suite.second, iterations, sink);
+        total += us;
+        std::printf("%-24s %5zu expressions %12.2f us\n", suite.first.c_str(), suite.second.size(), us);
+    }
+    std::printf("%-24s %32.2f us\n", "total", total);
+    return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+// Compare key lookups in order preserving objects (ojson) with and without their hash index
+// against sorted objects (json), for objects of 8 to 1000 members. The index is a compile time
+// setting, so build the driver twice:
+//
+//     make bench_object_index
+//
+// or by hand:
+//
+//     g++ -std=c++17 -O2 -Isrc/include benchmarks/bench_object_index.cpp -o scan
+//     g++ -std=c++17 -O2 -Isrc/include benchmarks/bench_object_index.cpp -o index -DJSONCONS_ORDER_PRESERVING_INDEX_THRESHOLD=32
+//
+// The Python module builds with the index at 32 members.
+
+#include <jsoncons/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename Json>
+double time_lookups(const Json& object, const std::vector<std::string>& keys, std::size_t rounds, int64_t& sum)
+{
+    double best = 1e30;
+    for (int repeat = 0; repeat < 5; ++repeat) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t round = 0; round < rounds; ++round) {
+            for (const auto& key : keys) {
+                auto it = object.find(key);
+                if (it != object.object_range().end()) {
+                    sum += it->value().template as<int64_t>();
+                }
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = (std::min)(best, elapsed.count() / static_cast<double>(rounds * keys.size()));
+    }
+    return best;
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("JSONCONS_ORDER_PRESERVING_INDEX_THRESHOLD=%d\n", JSONCONS_ORDER_PRESERVING_INDEX_THRESHOLD);
+    std::printf("%8s %18s %18s\n", "members", "ojson ns/lookup", "json ns/lookup");
+    std::mt19937 rng(42);
+    int64_t sum = 0;
+    for (std::size_t size : {8, 32, 200, 1000}) {
+        jsoncons::ojson ordered(jsoncons::json_object_arg);
+        jsoncons::json sorted(jsoncons::json_object_arg);
+        std::vector<std::string> keys;
+        for (std::size_t i = 0; i < size; ++i) {
+            std::string key = "field_" + std::to_string(rng() % 100000) + "_" + std::to_string(i);
+            ordered.try_emplace(key, static_cast<int64_t>(i));
+            sorted.try_emplace(key, static_cast<int64_t>(i));
+            keys.push_back(key);
+        }
+        // one lookup in ten misses
+        for (std::size_t i = 0; i < size / 10; ++i) {
+            keys.push_back("missing_" + std::to_string(i));
+        }
+        std::shuffle(keys.begin(), keys.end(), rng);
+        const std::size_t rounds = 2000000 / keys.size() + 1;
+        double ordered_ns = time_lookups(ordered, keys, rounds, sum);
+        double sorted_ns = time_lookups(sorted, keys, rounds, sum);
+        std::printf("%8zu %18.1f %18.1f\n", size, ordered_ns, sorted_ns);
+    }
+    return sum == 0 ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+"""
+Compare the parse time of Json.from_json with and without structural_index on the
+twitter, citm_catalog and canada documents of nativejson-benchmark
+(https://github.com/miloyip/nativejson-benchmark/tree/master/data):
+
+    python3 benchmarks/bench_parse.py path/to/nativejson-benchmark/data
+
+Without a directory, documents of the same shape are generated.
+"""
+
+from __future__ import annotations
+
+import functools
+import json
+import random
+import sys
+import timeit
+from pathlib import Path
+
+import pybind11_jsoncons as m
+
+NAMES = ["twitter.json", "citm_catalog.json", "canada.json"]
+
+
+def generate() -> dict[str, bytes]:
+    rng = random.Random(42)
+    statuses = [
+        {
+            "created_at": "Sun Aug 31 00:29:15 +0000 2014",
+            "id": 505874924095815681 + rng.getrandbits(32),
+            "text": "@aym0566x \n\u540d\u524d:\u524d\u7530\u3042\u3086\u307f caf\u00e9 http://t.co/abc",
+            "user": {
+                "id": rng.getrandbits(32),
+                "name": "some user name",
+                "description": "a description of reasonable length for a user profile field",
+                "followers_count": rng.randrange(10000),
+                "verified": False,
+                "url": None,
+            },
+            "entities": {"hashtags": [], "user_mentions": [{"screen_name": "aym0566x", "indices": [0, 9]}]},
+        }
+        for _ in range(3000)
+    ]
+    events = {
+        str(138586341 + i): {
+            "description": None,
+            "id": 138586341 + i,
+            "name": "30th Anniversary Tour",
+            "subTopicIds": [337184269, 337184283],
+            "topicIds": [324846099, 107888604],
+        }
+        for i in range(5000)
+    }
+    performances = [
+        {
+            "eventId": rng.randrange(1000000),
+            "id": rng.getrandbits(32),
+            "prices": [{"amount": 90250, "audienceSubCategoryId": 337100890, "seatCategoryId": 338937295}],
+            "start": 1372701600000,
+            "venueCode": "PLEYEL_PLEYEL",
+        }
+        for _ in range(3000)
+    ]
+    coordinates = [[rng.uniform(-100, 100), rng.uniform(-50, 50)] for _ in range(110000)]
+    docs = {
+        "twitter.json": {"statuses": statuses},
+        "citm_catalog.json": {"events": events, "performances": performances},
+        "canada.json": {"type": "FeatureCollection", "features": [{"geometry": {"coordinates": [coordinates]}}]},
+    }
+    return {name: json.dumps(doc, ensure_ascii=False).encode() for name, doc in docs.items()}
+
+
+def main() -> None:
+    if len(sys.argv) > 1:
+        texts = {name: (Path(sys.argv[1]) / name).read_bytes() for name in NAMES}
+    else:
+        texts = generate()
+    for name, text in texts.items():
+        times = {}
+        for structural_index in [False, True]:
+            doc = m.Json()
+            parse = functools.partial(doc.from_json, text, structural_index=structural_index)
+            times[structural_index] = min(timeit.repeat(parse, number=1, repeat=20))
+        print(
+            f"{name:20} {len(text) / 1e6:6.2f} MB  "
+            f"classic {times[False] * 1e3:8.2f} ms  structural_index {times[True] * 1e3:8.2f} ms  "
+            f"speedup {times[False] / times[True]:.2f}x"
+        )
+
+
+if __name__ == "__main__":
+    main()
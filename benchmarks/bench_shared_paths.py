@@ -0,0 +1,58 @@
+"""
+Time JsonQuery.process_batch with a predicate and 20 transforms that all start with
+payload.meta.source, whose leading lookups JsonQuery shares, against 20 transforms of the same
+depth under different top level fields (p0.meta.source ... p19.meta.source), which share
+nothing. Both read the same messages:
+
+    python3 benchmarks/bench_shared_paths.py [num_messages]
+"""
+
+from __future__ import annotations
+
+import functools
+import sys
+import timeit
+
+import pybind11_jsoncons as m
+
+NUM_TRANSFORMS = 20
+
+
+def make_messages(count: int) -> list[bytes]:
+    def source(i: int) -> dict:
+        fields = {f"f{k}": i + k for k in range(40)}
+        return {"host": "h", "port": 80, "tags": ["a", "b"], **fields}
+
+    messages = []
+    for i in range(count):
+        doc = {"kind": "x", "payload": {"meta": {"source": source(i), "ts": i}, "items": [1, 2, 3]}}
+        doc.update({f"p{k}": {"meta": {"source": source(i), "ts": i}} for k in range(NUM_TRANSFORMS)})
+        messages.append(m.Json().from_python(doc).to_msgpack())
+    return messages
+
+
+def run(jql: m.JsonQuery, messages: list[bytes]) -> int:
+    jql.clear()
+    return jql.process_batch(messages)
+
+
+def main() -> None:
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 20000
+    messages = make_messages(count)
+    transforms = {
+        "shared": [f"payload.meta.source.f{2 * k}" for k in range(NUM_TRANSFORMS)],
+        "distinct": [f"p{k}.meta.source.f{2 * k}" for k in range(NUM_TRANSFORMS)],
+    }
+    times = {}
+    for name, exprs in transforms.items():
+        jql = m.JsonQuery()
+        jql.setup_predicate("kind == 'x'")
+        jql.setup_transforms(exprs)
+        assert run(jql, messages) == count
+        times[name] = min(timeit.repeat(functools.partial(run, jql, messages), number=1, repeat=5))
+        print(f"{name:10} {count} messages  {times[name] * 1e3:8.2f} ms")
+    print(f"shared prefixes take {times['shared'] / times['distinct']:.2f}x the time of distinct ones")
+
+
+if __name__ == "__main__":
+    main()
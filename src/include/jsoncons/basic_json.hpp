@@ -39,6 +39,7 @@
 #include <jsoncons/json_object.hpp>
 #include <jsoncons/json_options.hpp>
 #include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_structural_parser.hpp>
 #include <jsoncons/json_type.hpp>
 #include <jsoncons/reflect/json_conv_traits.hpp>
 #include <jsoncons/pretty_print.hpp>
@@ -659,6 +660,50 @@ namespace jsoncons {
             }
         };
 
+        // string_view_storage refers to characters owned by someone else, such as a buffer
+        // parsed in situ. The characters must be followed by a null character and outlive the value.
+        // Moves keep the view; copies make an owning long string.
+        struct string_view_storage
+        {
+            static constexpr size_t max_length = (std::numeric_limits<uint32_t>::max)();
+
+            uint8_t storage_kind_:4;
+            uint8_t short_str_length_:4;
+            semantic_tag tag_;
+            uint32_t length_;
+            const char_type* data_;
+
+            string_view_storage(const char_type* data, std::size_t length, semantic_tag tag)
+                : storage_kind_(static_cast<uint8_t>(json_storage_kind::str_view)), short_str_length_(0), tag_(tag), 
+                  length_(static_cast<uint32_t>(length)), data_(data)
+            {
+            }
+
+            string_view_storage(const string_view_storage& other) = default;
+
+            string_view_storage& operator=(const string_view_storage& other) = delete;
+
+            semantic_tag tag() const
+            {
+                return tag_;
+            }
+
+            const char_type* data() const
+            {
+                return data_;
+            }
+
+            const char_type* c_str() const
+            {
+                return data_;
+            }
+
+            std::size_t length() const
+            {
+                return length_;
+            }
+        };
+
         // byte_string_storage
         struct byte_string_storage 
         {
@@ -872,6 +917,7 @@ namespace jsoncons {
             double_storage float64_;
             short_string_storage short_str_;
             long_string_storage long_str_;
+            string_view_storage str_view_;
             byte_string_storage byte_str_;
             array_storage array_;
             object_storage object_;
@@ -1087,6 +1133,16 @@ namespace jsoncons {
             return long_str_;
         }
 
+        string_view_storage& cast(identity<string_view_storage>)
+        {
+            return str_view_;
+        }
+
+        const string_view_storage& cast(identity<string_view_storage>) const
+        {
+            return str_view_;
+        }
+
         byte_string_storage& cast(identity<byte_string_storage>)
         {
             return byte_str_;
@@ -1165,6 +1221,7 @@ namespace jsoncons {
                 case json_storage_kind::float64       : swap_l_r<TypeL, double_storage>(other); break;
                 case json_storage_kind::short_str : swap_l_r<TypeL, short_string_storage>(other); break;
                 case json_storage_kind::long_str  : swap_l_r<TypeL, long_string_storage>(other); break;
+                case json_storage_kind::str_view  : swap_l_r<TypeL, string_view_storage>(other); break;
                 case json_storage_kind::byte_str  : swap_l_r<TypeL, byte_string_storage>(other); break;
                 case json_storage_kind::array        : swap_l_r<TypeL, array_storage>(other); break;
                 case json_storage_kind::object       : swap_l_r<TypeL, object_storage>(other); break;
@@ -1178,7 +1235,11 @@ namespace jsoncons {
 
         void uninitialized_copy(const basic_json& other)
         {
-            if (is_trivial_storage(other.storage_kind()))
+            if (other.storage_kind() == json_storage_kind::str_view)
+            {
+                uninitialized_copy_a(other, Allocator());
+            }
+            else if (is_trivial_storage(other.storage_kind()))
             {
                 std::memcpy(static_cast<void*>(this), &other, sizeof(basic_json));
             }
@@ -1227,7 +1288,14 @@ namespace jsoncons {
 
         void uninitialized_copy_a(const basic_json& other, const Allocator& alloc)
         {
-            if (is_trivial_storage(other.storage_kind()))
+            if (other.storage_kind() == json_storage_kind::str_view)
+            {
+                // A copy owns its characters, so it stays valid after the viewed buffer is gone
+                const auto& storage = other.cast<string_view_storage>();
+                auto ptr = create_long_string(alloc, storage.data(), storage.length());
+                construct<long_string_storage>(ptr, other.tag());
+            }
+            else if (is_trivial_storage(other.storage_kind()))
             {
                 std::memcpy(static_cast<void*>(this), &other, sizeof(basic_json));
             }
@@ -1322,7 +1390,13 @@ namespace jsoncons {
 
         void copy_assignment(const basic_json& other)
         {
-            if (is_trivial_storage(other.storage_kind()))
+            if (other.storage_kind() == json_storage_kind::str_view)
+            {
+                auto alloc = get_allocator();
+                destroy();
+                uninitialized_copy_a(other, alloc);
+            }
+            else if (is_trivial_storage(other.storage_kind()))
             {
                 destroy();
                 std::memcpy(static_cast<void*>(this), &other, sizeof(basic_json));
@@ -1453,6 +1527,7 @@ namespace jsoncons {
                     return json_type::float64;
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                     return json_type::string;
                 case json_storage_kind::byte_str:
                     return json_type::byte_string;
@@ -1527,6 +1602,8 @@ namespace jsoncons {
                     return result_type(in_place, cast<short_string_storage>().data(),cast<short_string_storage>().length());
                 case json_storage_kind::long_str:
                     return result_type(in_place, cast<long_string_storage>().data(),cast<long_string_storage>().length());
+                case json_storage_kind::str_view:
+                    return result_type(in_place, cast<string_view_storage>().data(),cast<string_view_storage>().length());
                 case json_storage_kind::json_const_ref:
                     return result_type(cast<json_const_reference_storage>().value().as_string_view());
                 case json_storage_kind::json_ref:
@@ -1567,6 +1644,17 @@ namespace jsoncons {
                     }
                     return result_type(std::move(bytes));
                 }
+                case json_storage_kind::str_view:
+                {
+                    value_type bytes = jsoncons::make_obj_using_allocator<value_type>(aset.get_allocator());
+                    const auto& stor = cast<string_view_storage>();
+                    auto res = string_to_bytes(stor.data(), stor.data()+stor.length(), tag(), bytes);
+                    if (JSONCONS_UNLIKELY(res.ec != conv_errc{}))
+                    {
+                        return result_type(jsoncons::unexpect, conv_errc::not_byte_string);
+                    }
+                    return result_type(std::move(bytes));
+                }
                 case json_storage_kind::byte_str:
                 {
                     auto& bs = cast<byte_string_storage>();
@@ -1780,6 +1868,7 @@ namespace jsoncons {
                     break;
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                     if (is_number_tag(tag()))
                     {
                         double val1 = as_double(); 
@@ -1830,6 +1919,8 @@ namespace jsoncons {
                                 return as_string_view().compare(rhs.as_string_view());
                             case json_storage_kind::long_str:
                                 return as_string_view().compare(rhs.as_string_view());
+                            case json_storage_kind::str_view:
+                                return as_string_view().compare(rhs.as_string_view());
                             case json_storage_kind::json_const_ref:
                                 return compare(rhs.cast<json_const_reference_storage>().value());
                             case json_storage_kind::json_ref:
@@ -1924,6 +2015,7 @@ namespace jsoncons {
                     case json_storage_kind::float64: swap_l<double_storage>(other); break;
                     case json_storage_kind::short_str: swap_l<short_string_storage>(other); break;
                     case json_storage_kind::long_str: swap_l<long_string_storage>(other); break;
+                    case json_storage_kind::str_view: swap_l<string_view_storage>(other); break;
                     case json_storage_kind::byte_str: swap_l<byte_string_storage>(other); break;
                     case json_storage_kind::array: swap_l<array_storage>(other); break;
                     case json_storage_kind::object: swap_l<object_storage>(other); break;
@@ -1952,6 +2044,18 @@ namespace jsoncons {
                 JSONCONS_THROW(ser_error(json_errc::illegal_unicode_character,parser.line(),parser.column()));
             }
             std::size_t offset = (r.ptr - source.data());
+            if (options.structural_index())
+            {
+                json_decoder<basic_json> index_decoder;
+                basic_json_structural_parser<char_type> index_parser(options);
+                std::error_code ec;
+                index_parser.parse(source.data()+offset, source.size()-offset, index_decoder, ec);
+                if (!ec && index_decoder.is_valid())
+                {
+                    return index_decoder.get_result();
+                }
+                // Text that fails is parsed again below, so that the error reported is the same
+            }
             parser.update(source.data()+offset,source.size()-offset);
             parser.parse_some(decoder);
             parser.finish_parse(decoder);
@@ -1978,6 +2082,18 @@ namespace jsoncons {
                 JSONCONS_THROW(ser_error(json_errc::illegal_unicode_character,parser.line(),parser.column()));
             }
             std::size_t offset = (r.ptr - source.data());
+            if (options.structural_index())
+            {
+                json_decoder<basic_json> index_decoder(aset.get_allocator(), aset.get_temp_allocator());
+                basic_json_structural_parser<char_type,TempAlloc> index_parser(options, aset.get_temp_allocator());
+                std::error_code ec;
+                index_parser.parse(source.data()+offset, source.size()-offset, index_decoder, ec);
+                if (!ec && index_decoder.is_valid())
+                {
+                    return index_decoder.get_result();
+                }
+                // Text that fails is parsed again below, so that the error reported is the same
+            }
             parser.update(source.data()+offset,source.size()-offset);
             parser.parse_some(decoder);
             parser.finish_parse(decoder);
@@ -2016,6 +2132,51 @@ namespace jsoncons {
             return parse(aset, jsoncons::basic_string_view<char_type>(str, length), options);
         }
 
+        // from a mutable buffer
+
+        // Parses the text in place. Escapes are decoded into the buffer, a null character is written
+        // after each string, and strings too long to be stored inline refer to the buffer instead of
+        // being copied, so the buffer must outlive the result and any value moved out of it. Copies
+        // own their strings. Text that 
+        // basic_json_structural_parser hands to basic_json_parser is parsed as by parse, and the buffer 
+        // is left unchanged. Otherwise errors are those that basic_json_structural_parser reports.
+        static basic_json parse_in_situ(char_type* str, std::size_t length, 
+            const basic_json_decode_options<char_type>& options = basic_json_options<char_type>())
+        {
+            return parse_in_situ(make_alloc_set(Allocator()), str, length, options);
+        }
+
+        template <typename TempAlloc >
+        static basic_json parse_in_situ(const allocator_set<allocator_type,TempAlloc>& aset, 
+            char_type* str, std::size_t length,
+            const basic_json_decode_options<char_type>& options = basic_json_options<char_type>())
+        {
+            json_decoder<basic_json> decoder(aset.get_allocator(), aset.get_temp_allocator());
+            basic_json_structural_parser<char_type,TempAlloc> parser(options, aset.get_temp_allocator());
+
+            auto r = unicode_traits::detect_encoding_from_bom(str, length);
+            if (!(r.encoding == unicode_traits::encoding_kind::utf8 || r.encoding == unicode_traits::encoding_kind::undetected))
+            {
+                JSONCONS_THROW(ser_error(json_errc::illegal_unicode_character,parser.line(),parser.column()));
+            }
+            std::size_t offset = (r.ptr - str);
+            decoder.reference_strings_in(str+offset, length-offset);
+            std::error_code ec;
+            if (!parser.parse_in_situ(str+offset, length-offset, decoder, ec))
+            {
+                return parse(aset, jsoncons::basic_string_view<char_type>(str, length), options);
+            }
+            if (JSONCONS_UNLIKELY(ec))
+            {
+                JSONCONS_THROW(ser_error(ec,parser.line(),parser.column()));
+            }
+            if (JSONCONS_UNLIKELY(!decoder.is_valid()))
+            {
+                JSONCONS_THROW(ser_error(json_errc::source_error, "Failed to parse json string"));
+            }
+            return decoder.get_result();
+        }
+
         // from stream
 
         static basic_json parse(std::basic_istream<char_type>& is, 
@@ -2557,6 +2718,30 @@ namespace jsoncons {
             }
         }
 
+        // Refers to s instead of copying it, unless it is short enough to be stored inline.
+        // s[length] must be a null character, and s must outlive the value and all copies of it.
+        basic_json(string_view_arg_t, const char_type* s, std::size_t length, semantic_tag tag = semantic_tag::none)
+            : basic_json(string_view_arg, s, length, tag, Allocator())
+        {
+        }
+
+        basic_json(string_view_arg_t, const char_type* s, std::size_t length, semantic_tag tag, const Allocator& alloc)
+        {
+            if (length <= short_string_storage::max_length)
+            {
+                construct<short_string_storage>(s, static_cast<uint8_t>(length), tag);
+            }
+            else if (length <= string_view_storage::max_length)
+            {
+                construct<string_view_storage>(s, length, tag);
+            }
+            else
+            {
+                auto ptr = create_long_string(alloc, s, length);
+                construct<long_string_storage>(ptr, tag);
+            }
+        }
+
         basic_json(half_arg_t, uint16_t val, semantic_tag tag = semantic_tag::none)
         {
             construct<half_storage>(val, tag);
@@ -3242,6 +3427,7 @@ namespace jsoncons {
             {
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                     return is_number_tag(tag());
                 case json_storage_kind::json_const_ref:
                     return cast<json_const_reference_storage>().value().is_bignum();
@@ -3373,6 +3559,7 @@ namespace jsoncons {
                     return true;
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                     return is_number_tag(tag());
                 case json_storage_kind::json_const_ref:
                     return cast<json_const_reference_storage>().value().is_number();
@@ -3394,6 +3581,8 @@ namespace jsoncons {
                     return cast<short_string_storage>().length() == 0;
                 case json_storage_kind::long_str:
                     return cast<long_string_storage>().length() == 0;
+                case json_storage_kind::str_view:
+                    return cast<string_view_storage>().length() == 0;
                 case json_storage_kind::array:
                     return cast<array_storage>().value().empty();
                 case json_storage_kind::empty_object:
@@ -3547,6 +3736,7 @@ namespace jsoncons {
             {
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                 {
                     switch (tag())
                     {
@@ -3617,6 +3807,7 @@ namespace jsoncons {
             {
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                 {
                     T val;
                     auto result = jsoncons::to_integer<T>(as_string_view().data(), as_string_view().length(), val);
@@ -3683,6 +3874,7 @@ namespace jsoncons {
             {
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                 {
                     T val;
                     auto result = jsoncons::to_integer<T>(as_string_view().data(), as_string_view().length(), val);
@@ -3728,6 +3920,7 @@ namespace jsoncons {
             {
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                 {
                     IntegerType val;
                     auto result = jsoncons::to_integer<IntegerType>(as_string_view().data(), as_string_view().length(), val);
@@ -3754,6 +3947,7 @@ namespace jsoncons {
             {
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                 {
                     double x{0};
                     const char_type* s = as_cstring();
@@ -3832,6 +4026,11 @@ namespace jsoncons {
                     auto& stor = cast<long_string_storage>();
                     return result_type(jsoncons::make_obj_using_allocator<value_type>(aset.get_allocator(), stor.data(), stor.length()));
                 }
+                case json_storage_kind::str_view:
+                {
+                    auto& stor = cast<string_view_storage>();
+                    return result_type(jsoncons::make_obj_using_allocator<value_type>(aset.get_allocator(), stor.data(), stor.length()));
+                }
                 case json_storage_kind::byte_str:
                 {
                     auto& stor = cast<byte_string_storage>();
@@ -3889,6 +4088,8 @@ namespace jsoncons {
                     return cast<short_string_storage>().c_str();
                 case json_storage_kind::long_str:
                     return cast<long_string_storage>().c_str();
+                case json_storage_kind::str_view:
+                    return cast<string_view_storage>().c_str();
                 case json_storage_kind::json_const_ref:
                     return cast<json_const_reference_storage>().value().as_cstring();
                 case json_storage_kind::json_ref:
@@ -4046,6 +4247,41 @@ namespace jsoncons {
             }
         }
 
+        // Looks up key with a single search, returns nullptr if this is not an object or has no such member
+        basic_json* find_value(const string_view_type& key) noexcept
+        {
+            switch (storage_kind())
+            {
+                case json_storage_kind::object:
+                {
+                    auto it = cast<object_storage>().value().find(key);
+                    return it != cast<object_storage>().value().end() ? std::addressof((*it).value()) : nullptr;
+                }
+                case json_storage_kind::json_ref:
+                    return cast<json_reference_storage>().value().find_value(key);
+                default:
+                    return nullptr;
+            }
+        }
+
+        const basic_json* find_value(const string_view_type& key) const noexcept
+        {
+            switch (storage_kind())
+            {
+                case json_storage_kind::object:
+                {
+                    auto it = cast<object_storage>().value().find(key);
+                    return it != cast<object_storage>().value().end() ? std::addressof((*it).value()) : nullptr;
+                }
+                case json_storage_kind::json_const_ref:
+                    return cast<json_const_reference_storage>().value().find_value(key);
+                case json_storage_kind::json_ref:
+                    return cast<json_reference_storage>().value().find_value(key);
+                default:
+                    return nullptr;
+            }
+        }
+
         template <typename T,typename U>
         T get_value_or(const string_view_type& key, U&& default_value) const
         {
@@ -4742,6 +4978,7 @@ namespace jsoncons {
             {
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                     visitor.string_value(as_string_view(), tag(), context, ec);
                     break;
                 case json_storage_kind::byte_str:
@@ -4817,6 +5054,7 @@ namespace jsoncons {
             {
                 case json_storage_kind::short_str:
                 case json_storage_kind::long_str:
+                case json_storage_kind::str_view:
                     visitor.string_value(as_string_view(), tag(), context, ec);
                     return ec ? write_result{unexpect, ec} : write_result{};
                 case json_storage_kind::byte_str:
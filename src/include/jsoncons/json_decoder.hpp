@@ -9,6 +9,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional> // std::less
 #include <memory> // std::allocator
 #include <system_error>
 #include <utility> // std::move
@@ -67,6 +68,8 @@ private:
     std::vector<index_key_value<Json>,stack_item_allocator_type> item_stack_;
     std::vector<structure_info,structure_info_allocator_type> structure_stack_;
     bool is_valid_{false};
+    const char_type* in_situ_first_{nullptr};
+    const char_type* in_situ_last_{nullptr};
 
 public:
     json_decoder(const allocator_type& alloc = allocator_type(), 
@@ -109,6 +112,15 @@ public:
         return is_valid_;
     }
 
+    // String values that lie within [data, data+length) and are followed by a null character,
+    // as basic_json_structural_parser::parse_in_situ leaves them, are stored as views into
+    // the buffer instead of being copied. The buffer must outlive the result.
+    void reference_strings_in(const char_type* data, std::size_t length)
+    {
+        in_situ_first_ = data;
+        in_situ_last_ = data + length;
+    }
+
     Json get_result()
     {
         JSONCONS_ASSERT(is_valid_);
@@ -218,6 +230,21 @@ private:
 
     JSONCONS_VISITOR_RETURN_TYPE visit_string(const string_view_type& sv, semantic_tag tag, const ser_context&, std::error_code&) override
     {
+        if (is_in_situ(sv))
+        {
+            switch (structure_stack_.back().type_)
+            {
+                case structure_type::object_t:
+                case structure_type::array_t:
+                    item_stack_.emplace_back(std::move(name_), index_++, string_view_arg, sv.data(), sv.size(), tag);
+                    break;
+                case structure_type::root_t:
+                    result_ = Json(string_view_arg, sv.data(), sv.size(), tag, allocator_);
+                    is_valid_ = true;
+                    JSONCONS_VISITOR_RETURN;
+            }
+            JSONCONS_VISITOR_RETURN;
+        }
         switch (structure_stack_.back().type_)
         {
             case structure_type::object_t:
@@ -232,6 +259,13 @@ private:
         JSONCONS_VISITOR_RETURN;
     }
 
+    bool is_in_situ(const string_view_type& sv) const
+    {
+        std::less<const char_type*> less;
+        return in_situ_first_ != nullptr && !less(sv.data(), in_situ_first_) && 
+            less(sv.data() + sv.size(), in_situ_last_) && sv.data()[sv.size()] == 0;
+    }
+
     JSONCONS_VISITOR_RETURN_TYPE visit_byte_string(const byte_string_view& b, 
                            semantic_tag tag, 
                            const ser_context&,
@@ -26,6 +26,12 @@
 #include <jsoncons/json_array.hpp>
 #include <jsoncons/json_exception.hpp>
 
+// Order preserving objects with at least this many members keep a hash index of their keys,
+// so that find no longer scans every member. 0 (the default) disables the index.
+#ifndef JSONCONS_ORDER_PRESERVING_INDEX_THRESHOLD
+#define JSONCONS_ORDER_PRESERVING_INDEX_THRESHOLD 0
+#endif
+
 namespace jsoncons {
 
     template <typename Json>
@@ -1031,8 +1037,14 @@ namespace jsoncons {
 
         using key_value_allocator_type = typename std::allocator_traits<allocator_type>:: template rebind_alloc<key_value_type>;
         using key_value_container_type = SequenceContainer<key_value_type,key_value_allocator_type>;
+        using index_allocator_type = typename std::allocator_traits<allocator_type>:: template rebind_alloc<std::size_t>;
+
+        static constexpr std::size_t index_threshold = JSONCONS_ORDER_PRESERVING_INDEX_THRESHOLD;
 
         key_value_container_type members_;
+        // Open addressing table of member positions plus one (0 marks a free slot), empty
+        // while the object has fewer than index_threshold members
+        std::vector<std::size_t,index_allocator_type> index_;
 
         struct Comp
         {
@@ -1057,31 +1069,36 @@ namespace jsoncons {
         }
         order_preserving_json_object(const allocator_type& alloc)
             : allocator_holder<allocator_type>(alloc), 
-              members_(key_value_allocator_type(alloc))
+              members_(key_value_allocator_type(alloc)),
+              index_(index_allocator_type(alloc))
         {
         }
 
         order_preserving_json_object(const order_preserving_json_object& val)
             : allocator_holder<allocator_type>(val.get_allocator()), 
-              members_(val.members_)
+              members_(val.members_),
+              index_(val.index_)
         {
         }
 
         order_preserving_json_object(order_preserving_json_object&& val,const allocator_type& alloc) 
             : allocator_holder<allocator_type>(alloc), 
-              members_(std::move(val.members_),key_value_allocator_type(alloc))
+              members_(std::move(val.members_),key_value_allocator_type(alloc)),
+              index_(std::move(val.index_),index_allocator_type(alloc))
         {
         }
 
         order_preserving_json_object(order_preserving_json_object&& val) noexcept
             : allocator_holder<allocator_type>(val.get_allocator()), 
-              members_(std::move(val.members_))
+              members_(std::move(val.members_)),
+              index_(std::move(val.index_))
         {
         }
 
         order_preserving_json_object(const order_preserving_json_object& val, const allocator_type& alloc) 
             : allocator_holder<allocator_type>(alloc), 
-              members_(val.members_,key_value_allocator_type(alloc))
+              members_(val.members_,key_value_allocator_type(alloc)),
+              index_(val.index_,index_allocator_type(alloc))
         {
         }
 
@@ -1100,12 +1117,14 @@ namespace jsoncons {
                     members_.emplace_back(std::move(kv));
                 }
             }
+            rebuild_index();
         }
 
         template <typename InputIt>
         order_preserving_json_object(InputIt first, InputIt last, const allocator_type& alloc)
             : allocator_holder<allocator_type>(alloc), 
-              members_(key_value_allocator_type(alloc))
+              members_(key_value_allocator_type(alloc)),
+              index_(index_allocator_type(alloc))
         {
             std::unordered_set<key_type,MyHash> keys;
             for (auto it = first; it != last; ++it)
@@ -1117,12 +1136,14 @@ namespace jsoncons {
                     members_.emplace_back(std::move(kv));
                 }
             }
+            rebuild_index();
         }
 
         order_preserving_json_object(std::initializer_list<std::pair<std::basic_string<char_type>,Json>> init, 
                     const allocator_type& alloc = allocator_type())
             : allocator_holder<allocator_type>(alloc), 
-              members_(key_value_allocator_type(alloc))
+              members_(key_value_allocator_type(alloc)),
+              index_(index_allocator_type(alloc))
         {
             members_.reserve(init.size());
             for (auto& item : init)
@@ -1144,13 +1165,17 @@ namespace jsoncons {
 
         order_preserving_json_object& operator=(const order_preserving_json_object& val)
         {
+            // an empty index is always consistent, so a throwing copy cannot leave a stale one behind
+            index_.clear();
             members_ = val.members_;
+            index_ = val.index_;
             return *this;
         }
 
         void swap(order_preserving_json_object& other) noexcept
         {
             members_.swap(other.members_);
+            index_.swap(other.index_);
         }
 
         bool empty() const
@@ -1185,6 +1210,7 @@ namespace jsoncons {
         void clear() 
         {
             members_.clear();
+            index_.clear();
         }
 
         void shrink_to_fit() 
@@ -1218,6 +1244,10 @@ namespace jsoncons {
 
         iterator find(const string_view_type& name) noexcept
         {
+            if (!index_.empty())
+            {
+                return members_.begin() + find_in_index(name);
+            }
             bool found = false;
             auto it = members_.begin();
             while (!found && it != members_.end())
@@ -1236,6 +1266,10 @@ namespace jsoncons {
 
         const_iterator find(const string_view_type& name) const noexcept
         {
+            if (!index_.empty())
+            {
+                return members_.begin() + find_in_index(name);
+            }
             bool found = false;
             auto it = members_.begin();
             while (!found && it != members_.end())
@@ -1256,7 +1290,9 @@ namespace jsoncons {
         {
             if (pos != members_.end())
             {
-                return members_.erase(pos);
+                auto it = members_.erase(pos);
+                rebuild_index();
+                return it;
             }
             else
             {
@@ -1271,8 +1307,9 @@ namespace jsoncons {
 
             if (pos1 < members_.size() && pos2 <= members_.size())
             {
-
-                return members_.erase(first,last);
+                auto it = members_.erase(first,last);
+                rebuild_index();
+                return it;
             }
             else
             {
@@ -1286,6 +1323,7 @@ namespace jsoncons {
             if (pos != members_.end())
             {
                 members_.erase(pos);
+                rebuild_index();
             }
         }
 
@@ -1334,6 +1372,7 @@ namespace jsoncons {
                 {
                     members_.emplace_back(std::move(items[i].name), std::move(items[i].value));
                 }
+                rebuild_index();
             }
         }
 
@@ -1348,6 +1387,7 @@ namespace jsoncons {
                 {
                     keys.emplace(key.c_str(), key.size(), get_allocator());
                     members_.emplace_back(std::move(key), (*it).second);
+                    append_to_index();
                 }
             }
         }
@@ -1358,6 +1398,7 @@ namespace jsoncons {
             for (auto it = first; it != last; ++it)
             {
                 members_.emplace_back(make_key_value<KeyT,Json>()(*it));
+                append_to_index();
             }
         }
    
@@ -1369,6 +1410,7 @@ namespace jsoncons {
             if (it == members_.end())
             {
                 members_.emplace_back(key_type(name.begin(), name.end()), std::forward<T>(value));
+                append_to_index();
                 auto pos = members_.begin() + (members_.size() - 1);
                 return std::make_pair(pos, true);
             }
@@ -1387,6 +1429,7 @@ namespace jsoncons {
             if (it == members_.end())
             {
                 members_.emplace_back(key_type(name.begin(),name.end(),get_allocator()), std::forward<T>(value));
+                append_to_index();
                 auto pos = members_.begin() + (members_.size()-1);
                 return std::make_pair(pos,true);
             }
@@ -1412,6 +1455,7 @@ namespace jsoncons {
                 if (it == members_.end())
                 {
                     members_.emplace_back(key_type(key.begin(), key.end()), std::forward<T>(value));
+                    append_to_index();
                     auto pos = members_.begin() + (members_.size() - 1);
                     return pos;
                 }
@@ -1438,6 +1482,7 @@ namespace jsoncons {
                 if (it == members_.end())
                 {
                     members_.emplace_back(key_type(key.begin(),key.end(),get_allocator()), std::forward<T>(value));
+                    append_to_index();
                     auto pos = members_.begin() + (members_.size()-1);
                     return pos;
                 }
@@ -1592,6 +1637,7 @@ namespace jsoncons {
             if (it == members_.end())
             {
                 members_.emplace_back(key_type(name.begin(), name.end()), std::forward<Args>(args)...);
+                append_to_index();
                 auto pos = members_.begin() + (members_.size()-1);
                 return std::make_pair(pos,true);
             }
@@ -1610,6 +1656,7 @@ namespace jsoncons {
             {
                 members_.emplace_back(key_type(key.begin(),key.end(), get_allocator()), 
                     std::forward<Args>(args)...);
+                append_to_index();
                 auto pos = members_.begin() + members_.size();
                 return std::make_pair(pos,true);
             }
@@ -1635,6 +1682,7 @@ namespace jsoncons {
                 {
                     members_.emplace_back(key_type(key.begin(),key.end(), get_allocator()), 
                         std::forward<Args>(args)...);
+                    append_to_index();
                     auto pos = members_.begin() + members_.size();
                     return pos;
                 }
@@ -1661,6 +1709,7 @@ namespace jsoncons {
                 {
                     members_.emplace_back(key_type(key.begin(),key.end(), get_allocator()), 
                         std::forward<Args>(args)...);
+                    append_to_index();
                     auto pos = members_.begin() + members_.size();
                     return pos;
                 }
@@ -1684,6 +1733,10 @@ namespace jsoncons {
 
         iterator find(iterator hint, const string_view_type& name) noexcept
         {
+            if (!index_.empty())
+            {
+                return find(name);
+            }
             bool found = false;
             auto it = hint;
             while (!found && it != members_.end())
@@ -1700,6 +1753,89 @@ namespace jsoncons {
             return found ? it : find(name);
         }
 
+        static std::size_t hash_key(const string_view_type& name) noexcept
+        {
+            // FNV-1a
+            std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+            for (auto c : name)
+            {
+                h ^= static_cast<std::size_t>(c);
+                h *= static_cast<std::size_t>(1099511628211ULL);
+            }
+            return h;
+        }
+
+        // Position of the member named name, or size() if there is none
+        std::size_t find_in_index(const string_view_type& name) const noexcept
+        {
+            const std::size_t mask = index_.size() - 1;
+            for (std::size_t slot = hash_key(name) & mask; index_[slot] != 0; slot = (slot + 1) & mask)
+            {
+                const std::size_t i = index_[slot] - 1;
+                if (members_[i].key() == name)
+                {
+                    return i;
+                }
+            }
+            return members_.size();
+        }
+
+        void index_member(std::size_t i) noexcept
+        {
+            const std::size_t mask = index_.size() - 1;
+            std::size_t slot = hash_key(members_[i].key()) & mask;
+            while (index_[slot] != 0)
+            {
+                slot = (slot + 1) & mask;
+            }
+            index_[slot] = i + 1;
+        }
+
+        void rebuild_index()
+        {
+            // cleared first so that a failed allocation leaves no index rather than a stale one
+            index_.clear();
+            if (index_threshold == 0 || members_.size() < index_threshold)
+            {
+                return;
+            }
+            std::size_t capacity = 16;
+            while (capacity < 2*members_.size()) // load factor at most 1/2
+            {
+                capacity *= 2;
+            }
+            std::vector<std::size_t,index_allocator_type> index(capacity, 0, index_.get_allocator());
+            index_.swap(index);
+            for (std::size_t i = 0; i < members_.size(); ++i)
+            {
+                index_member(i);
+            }
+        }
+
+        // Called after a member has been appended to members_
+        void append_to_index()
+        {
+            if (index_threshold == 0)
+            {
+                return;
+            }
+            if (index_.empty())
+            {
+                if (members_.size() >= index_threshold)
+                {
+                    rebuild_index();
+                }
+            }
+            else if (2*members_.size() > index_.size())
+            {
+                rebuild_index();
+            }
+            else
+            {
+                index_member(members_.size() - 1);
+            }
+        }
+
         void flatten_and_destroy() noexcept
         {
             if (!members_.empty())
@@ -260,6 +260,7 @@ private:
     bool lossless_bignum_{true};
     bool allow_comments_{true};
     bool allow_trailing_comma_{false};
+    bool structural_index_{false};
     std::function<bool(json_errc,const ser_context&)> err_handler_;
 public:
     basic_json_decode_options()
@@ -275,6 +276,7 @@ public:
           lossless_bignum_(other.lossless_bignum_), 
           allow_comments_(other.allow_comments_), 
           allow_trailing_comma_(other.allow_trailing_comma_), 
+          structural_index_(other.structural_index_), 
           err_handler_(std::move(other.err_handler_))
     {
     }
@@ -301,6 +303,12 @@ public:
         return allow_trailing_comma_;
     }
 
+    // Whether text held in memory is parsed with basic_json_structural_parser
+    bool structural_index() const 
+    {
+        return structural_index_;
+    }
+
 #if !defined(JSONCONS_NO_DEPRECATED)
     const std::function<bool(json_errc,const ser_context&)>& err_handler() const 
     {
@@ -501,6 +509,7 @@ public:
     using basic_json_decode_options<CharT>::lossless_bignum;
     using basic_json_decode_options<CharT>::allow_comments;
     using basic_json_decode_options<CharT>::allow_trailing_comma;
+    using basic_json_decode_options<CharT>::structural_index;
 #if !defined(JSONCONS_NO_DEPRECATED)
     using basic_json_decode_options<CharT>::err_handler;
 #endif
@@ -677,6 +686,12 @@ public:
         return *this;
     }
 
+    basic_json_options& structural_index(bool value) 
+    {
+        this->structural_index_ = value;
+        return *this;
+    }
+
 #if !defined(JSONCONS_NO_DEPRECATED)
     basic_json_options& err_handler(const std::function<bool(json_errc,const ser_context&)>& value) 
     {
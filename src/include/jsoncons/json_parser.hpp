@@ -9,6 +9,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring> // std::memcpy
 #include <functional> // std::function
 #include <limits> // std::numeric_limits
 #include <memory> // std::allocator
@@ -30,6 +31,25 @@
 #include <jsoncons/ser_util.hpp>
 #include <jsoncons/utility/unicode_traits.hpp>
 
+// The AVX2 kernels are built with the target attribute when the build does not enable AVX2,
+// and only run if the CPU supports it, see detail::cpu_has_avx2
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JSONCONS_STRING_SCAN_AVX2 1
+#define JSONCONS_AVX2_TARGET
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define JSONCONS_STRING_SCAN_AVX2 1
+#define JSONCONS_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSONCONS_STRING_SCAN_SSE2 1
+#endif
+#if defined(_MSC_VER) && (defined(JSONCONS_STRING_SCAN_AVX2) || defined(JSONCONS_STRING_SCAN_SSE2))
+#include <intrin.h> // _BitScanForward
+#endif
+
 #define JSONCONS_ILLEGAL_CONTROL_CHARACTER \
         case 0x00:case 0x01:case 0x02:case 0x03:case 0x04:case 0x05:case 0x06:case 0x07:case 0x08:case 0x0b: \
         case 0x0c:case 0x0e:case 0x0f:case 0x10:case 0x11:case 0x12:case 0x13:case 0x14:case 0x15:case 0x16: \
@@ -39,6 +59,151 @@ namespace jsoncons {
 
 namespace detail {
 
+    // Index of the lowest set bit of a nonzero mask
+    inline int lowest_bit(uint32_t mask)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+#if defined(JSONCONS_STRING_SCAN_AVX2)
+    // True if the AVX2 kernels may run, checked once
+    inline bool cpu_has_avx2()
+    {
+#if defined(__AVX2__)
+        return true;
+#else
+        static const bool has_avx2 = []()
+        {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+        }();
+        return has_avx2;
+#endif
+    }
+#endif
+
+    // The kernels of skip_string_text skip whole blocks of characters, returning the position of
+    // the first special character or the start of the last, incomplete block
+#if defined(JSONCONS_STRING_SCAN_AVX2)
+    JSONCONS_AVX2_TARGET
+    inline const char* skip_string_blocks_avx2(const char* p, const char* last, bool& non_ascii)
+    {
+        const __m256i quote = _mm256_set1_epi8('\"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i max_control = _mm256_set1_epi8(0x1f);
+        while (last - p >= 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            // v <= 0x1f unsigned if min(v, 0x1f) == v
+            __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+                                              _mm256_cmpeq_epi8(_mm256_min_epu8(v, max_control), v));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+            uint32_t high = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+            if (mask != 0)
+            {
+                int index = lowest_bit(mask);
+                non_ascii = non_ascii || (high & ((uint32_t(1) << index) - 1)) != 0;
+                return p + index;
+            }
+            non_ascii = non_ascii || high != 0;
+            p += 32;
+        }
+        return p;
+    }
+#endif
+
+#if defined(JSONCONS_STRING_SCAN_SSE2)
+    inline const char* skip_string_blocks(const char* p, const char* last, bool& non_ascii)
+    {
+        const __m128i quote = _mm_set1_epi8('\"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i max_control = _mm_set1_epi8(0x1f);
+        while (last - p >= 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            // v <= 0x1f unsigned if min(v, 0x1f) == v
+            __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                           _mm_cmpeq_epi8(_mm_min_epu8(v, max_control), v));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+            uint32_t high = static_cast<uint32_t>(_mm_movemask_epi8(v));
+            if (mask != 0)
+            {
+                int index = lowest_bit(mask);
+                non_ascii = non_ascii || (high & ((uint32_t(1) << index) - 1)) != 0;
+                return p + index;
+            }
+            non_ascii = non_ascii || high != 0;
+            p += 16;
+        }
+        return p;
+    }
+#else
+    inline const char* skip_string_blocks(const char* p, const char* last, bool& non_ascii)
+    {
+        // eight characters at a time in a word, a word with a special character is finished by the caller
+        const uint64_t ones = 0x0101010101010101ULL;
+        const uint64_t highs = 0x8080808080808080ULL;
+        while (last - p >= 8)
+        {
+            uint64_t w;
+            std::memcpy(&w, p, 8);
+            uint64_t q = w ^ (ones * '\"');
+            uint64_t b = w ^ (ones * '\\');
+            // a byte below 0x20 or equal to quote or backslash has its high bit set in special
+            uint64_t special = ((w - ones * 0x20) | (q - ones) | (b - ones)) & ~w & highs;
+            if (special != 0)
+            {
+                break;
+            }
+            non_ascii = non_ascii || (w & highs) != 0;
+            p += 8;
+        }
+        return p;
+    }
+#endif
+
+    // Skips the characters of a string that need no handling, returning the first of [first,last)
+    // that is a '"', a '\\' or a control character, or last. Sets non_ascii if a skipped
+    // character may be outside ASCII, in which case the string must be checked to be valid UTF-8.
+    // Only UTF-8 text is scanned ahead, other character types are handled one at a time by the caller.
+    template <typename CharT>
+    const CharT* skip_string_text(const CharT* first, const CharT*, bool& non_ascii)
+    {
+        non_ascii = true;
+        return first;
+    }
+
+    inline const char* skip_string_text(const char* first, const char* last, bool& non_ascii)
+    {
+        const char* p;
+#if defined(JSONCONS_STRING_SCAN_AVX2)
+        if (cpu_has_avx2())
+        {
+            p = skip_string_blocks_avx2(first, last, non_ascii);
+        }
+        else
+#endif
+        {
+            p = skip_string_blocks(first, last, non_ascii);
+        }
+        for (; p < last; ++p)
+        {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c == '\"' || c == '\\' || c < 0x20)
+            {
+                return p;
+            }
+            non_ascii = non_ascii || c >= 0x80;
+        }
+        return p;
+    }
+
 }
 
 enum class parse_state : uint8_t 
@@ -149,6 +314,8 @@ private:
     bool more_{true};
     bool done_{false};
     bool cursor_mode_{false};
+    // Whether the string being parsed may hold characters outside ASCII
+    bool string_non_ascii_{false};
     int mark_level_{0};
     
     semantic_tag escape_tag_;
@@ -507,6 +674,7 @@ public:
         position_ = 0;
         mark_position_ = 0;
         level_ = 0;
+        string_non_ascii_ = false;
     }
 
     void restart()
@@ -611,12 +779,12 @@ public:
                 case parse_state::number:  
                     if (number_state_ == parse_number_state::zero || number_state_ == parse_number_state::integer)
                     {
-                        end_integer_value(visitor, ec);
+                        end_integer_value(string_view_type(buffer_.data(), buffer_.length()), visitor, ec);
                         if (JSONCONS_UNLIKELY(ec)) return;
                     }
                     else if (number_state_ == parse_number_state::fraction2 || number_state_ == parse_number_state::exp3)
                     {
-                        end_fraction_value(visitor, ec);
+                        end_fraction_value(string_view_type(buffer_.data(), buffer_.length()), visitor, ec);
                         if (JSONCONS_UNLIKELY(ec)) return;
                     }
                     else
@@ -723,7 +891,6 @@ public:
                             break;
                         case '-':
                             buffer_.clear();
-                            buffer_.push_back('-');
                             begin_position_ = position_;
                             ++input_ptr_;
                             ++position_;
@@ -734,7 +901,6 @@ public:
                             break;
                         case '0': 
                             buffer_.clear();
-                            buffer_.push_back(static_cast<char>(*input_ptr_));
                             state_ = parse_state::number;
                             number_state_ = parse_number_state::zero;
                             begin_position_ = position_;
@@ -745,7 +911,6 @@ public:
                             break;
                         case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
                             buffer_.clear();
-                            buffer_.push_back(static_cast<char>(*input_ptr_));
                             begin_position_ = position_;
                             ++input_ptr_;
                             ++position_;
@@ -1095,7 +1260,6 @@ public:
                             break;
                         case '-':
                             buffer_.clear();
-                            buffer_.push_back('-');
                             begin_position_ = position_;
                             ++input_ptr_;
                             ++position_;
@@ -1106,7 +1270,6 @@ public:
                             break;
                         case '0': 
                             buffer_.clear();
-                            buffer_.push_back(static_cast<char>(*input_ptr_));
                             begin_position_ = position_;
                             ++input_ptr_;
                             ++position_;
@@ -1117,7 +1280,6 @@ public:
                             break;
                         case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
                             buffer_.clear();
-                            buffer_.push_back(static_cast<char>(*input_ptr_));
                             begin_position_ = position_;
                             ++input_ptr_;
                             ++position_;
@@ -1247,7 +1409,6 @@ public:
                             break;
                         case '-':
                             buffer_.clear();
-                            buffer_.push_back('-');
                             begin_position_ = position_;
                             ++input_ptr_;
                             ++position_;
@@ -1258,7 +1419,6 @@ public:
                             break;
                         case '0': 
                             buffer_.clear();
-                            buffer_.push_back(static_cast<char>(*input_ptr_));
                             begin_position_ = position_;
                             ++input_ptr_;
                             ++position_;
@@ -1269,7 +1429,6 @@ public:
                             break;
                         case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8': case '9':
                             buffer_.clear();
-                            buffer_.push_back(static_cast<char>(*input_ptr_));
                             begin_position_ = position_;
                             ++input_ptr_;
                             ++position_;
@@ -1721,6 +1880,9 @@ public:
     {
         const char_type* cur = hdr;
         const char_type* local_input_end = input_end_;
+        // A number that starts in this chunk, the usual case, is read from the input, 
+        // and only a number that straddles chunks is accumulated in buffer_
+        const char_type* sb = buffer_.empty() ? hdr - 1 : hdr;
 
         switch (number_state_)
         {
@@ -1747,7 +1909,7 @@ minus_sign:
         if (JSONCONS_UNLIKELY(cur >= local_input_end)) // Buffer exhausted               
         {
             number_state_ = parse_number_state::minus;
-            buffer_.append(hdr, cur);
+            buffer_.append(sb, cur);
             position_ += (cur - hdr);
             return cur;
         }
@@ -1770,7 +1932,7 @@ zero:
         if (JSONCONS_UNLIKELY(cur >= local_input_end)) // Buffer exhausted               
         {
             number_state_ = parse_number_state::integer;
-            buffer_.append(hdr, cur);
+            buffer_.append(sb, cur);
             position_ += (cur - hdr);
             return cur;
         }
@@ -1794,9 +1956,8 @@ zero:
             position_ += (cur - hdr);
             return cur;
         }
-        buffer_.append(hdr, cur);
         position_ += (cur - hdr);
-        end_integer_value(visitor, ec);
+        end_integer_value(number_text(sb, hdr, cur), visitor, ec);
         return cur;
 integer:
         while (true)
@@ -1804,7 +1965,7 @@ integer:
             if (JSONCONS_UNLIKELY(cur >= local_input_end)) // Buffer exhausted               
             {
                 number_state_ = parse_number_state::integer;
-                buffer_.append(hdr, cur);
+                buffer_.append(sb, cur);
                 position_ += (cur - hdr);
                 return cur;
             }
@@ -1824,15 +1985,14 @@ integer:
             ++cur;
             goto exp1;
         }
-        buffer_.append(hdr, cur);
         position_ += (cur - hdr);
-        end_integer_value(visitor, ec);
+        end_integer_value(number_text(sb, hdr, cur), visitor, ec);
         return cur;
 fraction1:
         if (JSONCONS_UNLIKELY(cur >= local_input_end)) // Buffer exhausted               
         {
             number_state_ = parse_number_state::fraction1;
-            buffer_.append(hdr, cur);
+            buffer_.append(sb, cur);
             position_ += (cur - hdr);
             return cur;
         }
@@ -1853,7 +2013,7 @@ fraction2:
             if (JSONCONS_UNLIKELY(cur >= local_input_end)) // Buffer exhausted               
             {
                 number_state_ = parse_number_state::fraction2;
-                buffer_.append(hdr, cur);
+                buffer_.append(sb, cur);
                 position_ += (cur - hdr);
                 return cur;
             }
@@ -1868,15 +2028,14 @@ fraction2:
             ++cur;
             goto exp1;
         }
-        buffer_.append(hdr, cur);
         position_ += (cur - hdr);
-        end_fraction_value(visitor, ec);
+        end_fraction_value(number_text(sb, hdr, cur), visitor, ec);
         return cur;
 exp1:
         if (JSONCONS_UNLIKELY(cur >= local_input_end)) // Buffer exhausted               
         {
             number_state_ = parse_number_state::exp1;
-            buffer_.append(hdr, cur);
+            buffer_.append(sb, cur);
             position_ += (cur - hdr);
             return cur;
         }
@@ -1904,7 +2063,7 @@ exp2:
         if (JSONCONS_UNLIKELY(cur >= local_input_end)) // Buffer exhausted               
         {
             number_state_ = parse_number_state::exp2;
-            buffer_.append(hdr, cur);
+            buffer_.append(sb, cur);
             position_ += (cur - hdr);
             return cur;
         }
@@ -1925,7 +2084,7 @@ exp3:
             if (JSONCONS_UNLIKELY(cur >= local_input_end)) // Buffer exhausted               
             {
                 number_state_ = parse_number_state::exp3;
-                buffer_.append(hdr, cur);
+                buffer_.append(sb, cur);
                 position_ += (cur - hdr);
                 return cur;
             }
@@ -1935,9 +2094,8 @@ exp3:
             }
             ++cur;
         }
-        buffer_.append(hdr, cur);
         position_ += (cur - hdr);
-        end_fraction_value(visitor, ec);
+        end_fraction_value(number_text(sb, hdr, cur), visitor, ec);
         return cur;
     }
 
@@ -1979,6 +2137,11 @@ exp3:
 text:
         while (cur < local_input_end)
         {
+            cur = detail::skip_string_text(cur, local_input_end, string_non_ascii_);
+            if (cur == local_input_end)
+            {
+                break;
+            }
             switch (*cur)
             {
                 JSONCONS_ILLEGAL_CONTROL_CHARACTER:
@@ -2102,6 +2265,8 @@ escape:
             goto text;
         case 'u':
              cp_ = 0;
+             // the escaped code point may be appended as several UTF-8 bytes
+             string_non_ascii_ = true;
              ++cur;
              ++position_;
              goto escape_u1;
@@ -2443,22 +2608,32 @@ private:
         *ptr = cur;
     }
 
-    void end_integer_value(basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    string_view_type number_text(const char_type* sb, const char_type* hdr, const char_type* cur)
     {
-        if (buffer_[0] == '-')
+        if (sb != hdr)
         {
-            end_negative_value(visitor, ec);
+            return string_view_type(sb, static_cast<std::size_t>(cur - sb));
+        }
+        buffer_.append(hdr, cur);
+        return string_view_type(buffer_.data(), buffer_.length());
+    }
+
+    void end_integer_value(const string_view_type& sv, basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    {
+        if (sv[0] == '-')
+        {
+            end_negative_value(sv, visitor, ec);
         }
         else
         {
-            end_positive_value(visitor, ec);
+            end_positive_value(sv, visitor, ec);
         }
     }
 
-    void end_negative_value(basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    void end_negative_value(const string_view_type& sv, basic_json_visitor<char_type>& visitor, std::error_code& ec)
     {
         int64_t val;
-        auto result = jsoncons::dec_to_integer(buffer_.data(), buffer_.length(), val);
+        auto result = jsoncons::dec_to_integer(sv.data(), sv.length(), val);
         if (result)
         {
             visitor.int64_value(val, semantic_tag::none, *this, ec);
@@ -2467,12 +2642,12 @@ private:
         {
             if (lossless_bignum_)
             {
-                visitor.string_value(buffer_, semantic_tag::bigint, *this, ec);
+                visitor.string_value(sv, semantic_tag::bigint, *this, ec);
             }
             else
             {
                 double d{0};
-                result = jsoncons::decstr_to_double(&buffer_[0], buffer_.length(), d);
+                result = jsoncons::dec_to_double(sv.data(), sv.length(), d);
                 if (JSONCONS_LIKELY(result))
                 {
                     visitor.double_value(d, semantic_tag::none, *this, ec);
@@ -2494,10 +2669,10 @@ private:
         after_value(ec);
     }
 
-    void end_positive_value(basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    void end_positive_value(const string_view_type& sv, basic_json_visitor<char_type>& visitor, std::error_code& ec)
     {
         uint64_t val;
-        auto result = jsoncons::dec_to_integer(buffer_.data(), buffer_.length(), val);
+        auto result = jsoncons::dec_to_integer(sv.data(), sv.length(), val);
         if (result)
         {
             visitor.uint64_value(val, semantic_tag::none, *this, ec);
@@ -2506,12 +2681,12 @@ private:
         {
             if (lossless_bignum_)
             {
-                visitor.string_value(buffer_, semantic_tag::bigint, *this, ec);
+                visitor.string_value(sv, semantic_tag::bigint, *this, ec);
             }
             else
             {
                 double d{0};
-                result = jsoncons::decstr_to_double(&buffer_[0], buffer_.length(), d);
+                result = jsoncons::dec_to_double(sv.data(), sv.length(), d);
                 if (JSONCONS_LIKELY(result))
                 {
                     visitor.double_value(d, semantic_tag::none, *this, ec);
@@ -2532,16 +2707,16 @@ private:
         after_value(ec);
     }
 
-    void end_fraction_value(basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    void end_fraction_value(const string_view_type& sv, basic_json_visitor<char_type>& visitor, std::error_code& ec)
     {
         if (lossless_number_)
         {
-            visitor.string_value(buffer_, semantic_tag::bigdec, *this, ec);
+            visitor.string_value(sv, semantic_tag::bigdec, *this, ec);
         }
         else
         {
             double d{0};
-            auto result = jsoncons::decstr_to_double(&buffer_[0], buffer_.length(), d);
+            auto result = jsoncons::dec_to_double(sv.data(), sv.length(), d);
             if (JSONCONS_LIKELY(result))
             {
                 visitor.double_value(d, semantic_tag::none, *this, ec);
@@ -2550,7 +2725,7 @@ private:
             {
                 if (lossless_bignum_)
                 {
-                    visitor.string_value(buffer_, semantic_tag::bigdec, *this, ec);
+                    visitor.string_value(sv, semantic_tag::bigdec, *this, ec);
                 }
                 else
                 {
@@ -2572,12 +2747,17 @@ private:
     void end_string_value(const char_type* s, std::size_t length, basic_json_visitor<char_type>& visitor, std::error_code& ec) 
     {
         string_view_type sv(s, length);
-        auto result = unicode_traits::validate(s, length);
-        if (result.ec != unicode_traits::conv_errc())
+        // text that is all ASCII is valid UTF-8
+        if (string_non_ascii_)
         {
-            translate_conv_errc(result.ec,ec);
-            position_ += (result.ptr - s);
-            return;
+            string_non_ascii_ = false;
+            auto result = unicode_traits::validate(s, length);
+            if (result.ec != unicode_traits::conv_errc())
+            {
+                translate_conv_errc(result.ec,ec);
+                position_ += (result.ptr - s);
+                return;
+            }
         }
         switch (parent())
         {
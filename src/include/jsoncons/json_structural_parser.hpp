@@ -0,0 +1,1132 @@
+// Copyright 2013-2026 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_STRUCTURAL_PARSER_HPP
+#define JSONCONS_JSON_STRUCTURAL_PARSER_HPP
+
+#include <algorithm> // std::find_if
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <limits> // std::numeric_limits
+#include <memory> // std::allocator
+#include <string>
+#include <system_error>
+#include <type_traits> // std::make_unsigned
+#include <utility>
+#include <vector>
+
+#include <jsoncons/config/compiler_support.hpp>
+#include <jsoncons/json_error.hpp>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_options.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_visitor.hpp>
+#include <jsoncons/semantic_tag.hpp>
+#include <jsoncons/ser_util.hpp>
+#include <jsoncons/utility/read_number.hpp>
+#include <jsoncons/utility/unicode_traits.hpp>
+
+namespace jsoncons {
+
+namespace detail {
+
+    // Index of the lowest set bit of a nonzero mask
+    inline int lowest_bit(uint64_t mask)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+    #if defined(_M_X64) || defined(_M_ARM64)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<int>(index);
+    #else
+        uint32_t low = static_cast<uint32_t>(mask);
+        return low != 0 ? lowest_bit(low) : 32 + lowest_bit(static_cast<uint32_t>(mask >> 32));
+    #endif
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+
+    // Bit i of each mask is set if character i of a block of 64 characters is of that class
+    struct structural_block
+    {
+        uint64_t quote{0};
+        uint64_t backslash{0};
+        uint64_t op{0};      // '{', '}', '[', ']', ':' or ','
+        uint64_t space{0};   // ' ', '\t', '\n' or '\r'
+        uint64_t slash{0};
+        uint64_t control{0};
+        uint64_t high{0};    // a character outside ASCII
+    };
+
+    template <typename CharT>
+    void classify_block(const CharT* p, structural_block& block)
+    {
+        using uchar_type = typename std::make_unsigned<CharT>::type;
+
+        block = structural_block{};
+        for (int i = 0; i < 64; ++i)
+        {
+            uint64_t bit = uint64_t(1) << i;
+            uchar_type c = static_cast<uchar_type>(p[i]);
+            switch (c)
+            {
+                case '\"':
+                    block.quote |= bit;
+                    break;
+                case '\\':
+                    block.backslash |= bit;
+                    break;
+                case '{': case '}': case '[': case ']': case ':': case ',':
+                    block.op |= bit;
+                    break;
+                case '\n': case '\r': case '\t':
+                    block.space |= bit;
+                    block.control |= bit;
+                    break;
+                case ' ':
+                    block.space |= bit;
+                    break;
+                case '/':
+                    block.slash |= bit;
+                    break;
+                default:
+                    if (c < 0x20)
+                    {
+                        block.control |= bit;
+                    }
+                    else if (c >= 0x80)
+                    {
+                        block.high |= bit;
+                    }
+                    break;
+            }
+        }
+    }
+
+#if defined(JSONCONS_STRING_SCAN_AVX2)
+    JSONCONS_AVX2_TARGET
+    inline void classify_block_avx2(const char* p, structural_block& block)
+    {
+        // '[' and ']' differ from '{' and '}' only in bit 0x20
+        const __m256i lower = _mm256_set1_epi8(0x20);
+        const __m256i lbrace = _mm256_set1_epi8('{');
+        const __m256i rbrace = _mm256_set1_epi8('}');
+        const __m256i colon = _mm256_set1_epi8(':');
+        const __m256i comma = _mm256_set1_epi8(',');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i lf = _mm256_set1_epi8('\n');
+        const __m256i cr = _mm256_set1_epi8('\r');
+        const __m256i quote = _mm256_set1_epi8('\"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i slash = _mm256_set1_epi8('/');
+        const __m256i max_control = _mm256_set1_epi8(0x1f);
+
+        block = structural_block{};
+        for (int i = 0; i < 64; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            __m256i folded = _mm256_or_si256(v, lower);
+            __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, lbrace), _mm256_cmpeq_epi8(folded, rbrace)),
+                                         _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+            __m256i space = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, lower), _mm256_cmpeq_epi8(v, tab)),
+                                            _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr)));
+            // v <= 0x1f unsigned if min(v, 0x1f) == v
+            __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(v, max_control), v);
+
+            block.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << i;
+            block.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)))) << i;
+            block.slash |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, slash)))) << i;
+            block.op |= uint64_t(uint32_t(_mm256_movemask_epi8(op))) << i;
+            block.space |= uint64_t(uint32_t(_mm256_movemask_epi8(space))) << i;
+            block.control |= uint64_t(uint32_t(_mm256_movemask_epi8(control))) << i;
+            block.high |= uint64_t(uint32_t(_mm256_movemask_epi8(v))) << i;
+        }
+    }
+#endif
+
+#if defined(JSONCONS_STRING_SCAN_SSE2)
+    inline void classify_block_sse2(const char* p, structural_block& block)
+    {
+        // '[' and ']' differ from '{' and '}' only in bit 0x20
+        const __m128i lower = _mm_set1_epi8(0x20);
+        const __m128i lbrace = _mm_set1_epi8('{');
+        const __m128i rbrace = _mm_set1_epi8('}');
+        const __m128i colon = _mm_set1_epi8(':');
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i lf = _mm_set1_epi8('\n');
+        const __m128i cr = _mm_set1_epi8('\r');
+        const __m128i quote = _mm_set1_epi8('\"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i slash = _mm_set1_epi8('/');
+        const __m128i max_control = _mm_set1_epi8(0x1f);
+
+        block = structural_block{};
+        for (int i = 0; i < 64; i += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            __m128i folded = _mm_or_si128(v, lower);
+            __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, lbrace), _mm_cmpeq_epi8(folded, rbrace)),
+                                      _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+            __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, lower), _mm_cmpeq_epi8(v, tab)),
+                                         _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+            // v <= 0x1f unsigned if min(v, 0x1f) == v
+            __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, max_control), v);
+
+            block.quote |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << i;
+            block.backslash |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << i;
+            block.slash |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, slash)))) << i;
+            block.op |= uint64_t(uint32_t(_mm_movemask_epi8(op))) << i;
+            block.space |= uint64_t(uint32_t(_mm_movemask_epi8(space))) << i;
+            block.control |= uint64_t(uint32_t(_mm_movemask_epi8(control))) << i;
+            block.high |= uint64_t(uint32_t(_mm_movemask_epi8(v))) << i;
+        }
+    }
+#endif
+
+#if defined(JSONCONS_STRING_SCAN_AVX2) || defined(JSONCONS_STRING_SCAN_SSE2)
+    inline void classify_block(const char* p, structural_block& block)
+    {
+#if defined(JSONCONS_STRING_SCAN_AVX2)
+        if (cpu_has_avx2())
+        {
+            classify_block_avx2(p, block);
+            return;
+        }
+#endif
+#if defined(JSONCONS_STRING_SCAN_SSE2)
+        classify_block_sse2(p, block);
+#else
+        classify_block<char>(p, block);
+#endif
+    }
+#endif
+
+    // Bit i of the result is the parity of bits 0 through i of x
+    inline uint64_t prefix_xor(uint64_t x)
+    {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+    }
+
+} // namespace detail
+
+// A parser for a complete JSON text held in memory, which works in two stages. The first stage
+// classifies the input 64 characters at a time, and records the positions of the brackets, colons
+// and commas outside of strings, of the quotes, and of the first character of each number or literal.
+// The second stage walks those positions to check the grammar and send the events to the visitor.
+// Text that it does not take on, comments and inputs of 1GB or more, is handed to basic_json_parser,
+// as is text that fails the first stage, so that the error is the one basic_json_parser reports.
+// Other errors are found while events are being sent, and err_handler is not consulted.
+//
+// parse_in_situ parses a mutable buffer, decoding the escapes of each string back into the buffer and
+// writing a null character after it, so that the strings sent to the visitor remain valid for as long
+// as the buffer does.
+
+template <typename CharT,typename TempAlloc = std::allocator<char>>
+class basic_json_structural_parser : public ser_context
+{
+public:
+    using char_type = CharT;
+    using string_view_type = typename basic_json_visitor<CharT>::string_view_type;
+private:
+    struct string_maps_to_double
+    {
+        string_view_type s;
+
+        bool operator()(const std::pair<string_view_type,double>& val) const
+        {
+            return val.first == s;
+        }
+    };
+
+    enum class structure_kind : uint8_t {object, array};
+
+    using temp_allocator_type = TempAlloc;
+    using char_allocator_type = typename std::allocator_traits<temp_allocator_type>:: template rebind_alloc<CharT>;
+    using index_allocator_type = typename std::allocator_traits<temp_allocator_type>:: template rebind_alloc<uint32_t>;
+    using structure_allocator_type = typename std::allocator_traits<temp_allocator_type>:: template rebind_alloc<structure_kind>;
+
+    static constexpr std::size_t block_size = 64;
+    // Set on the position of the closing quote of a string that has escapes or control characters,
+    // or that has characters outside ASCII
+    static constexpr uint32_t escaped_string_flag = uint32_t(1) << 31;
+    static constexpr uint32_t non_ascii_string_flag = uint32_t(1) << 30;
+    static constexpr uint32_t position_mask = non_ascii_string_flag - 1;
+    static constexpr std::size_t max_length = non_ascii_string_flag;
+
+    basic_json_decode_options<char_type> options_;
+    temp_allocator_type temp_alloc_;
+    int max_nesting_depth_;
+    bool allow_trailing_comma_;
+    bool lossless_number_;
+    bool lossless_bignum_;
+
+    const char_type* data_{nullptr};
+    std::size_t length_{0};
+    // The buffer being parsed in situ, or null
+    char_type* in_situ_data_{nullptr};
+    std::size_t begin_position_{0};
+    std::size_t position_{0};
+    // Offset and line of the start of the last line found, so that line() and column() scan forward
+    mutable std::size_t line_scan_position_{0};
+    mutable std::size_t line_{1};
+    mutable std::size_t mark_position_{0};
+
+    std::vector<uint32_t,index_allocator_type> index_;
+    std::vector<structure_kind,structure_allocator_type> structure_stack_;
+    std::basic_string<char_type,std::char_traits<char_type>,char_allocator_type> buffer_;
+    std::vector<std::pair<std::basic_string<char_type>,double>> string_double_map_;
+
+    // Noncopyable and nonmoveable
+    basic_json_structural_parser(const basic_json_structural_parser&) = delete;
+    basic_json_structural_parser& operator=(const basic_json_structural_parser&) = delete;
+
+public:
+    basic_json_structural_parser()
+        : basic_json_structural_parser(basic_json_decode_options<char_type>())
+    {
+    }
+
+    explicit basic_json_structural_parser(const TempAlloc& temp_alloc)
+        : basic_json_structural_parser(basic_json_decode_options<char_type>(), temp_alloc)
+    {
+    }
+
+    basic_json_structural_parser(const basic_json_decode_options<char_type>& options,
+        const TempAlloc& temp_alloc = TempAlloc())
+       : options_(options),
+         temp_alloc_(temp_alloc),
+         max_nesting_depth_(options.max_nesting_depth()),
+         allow_trailing_comma_(options.allow_trailing_comma()),
+         lossless_number_(options.lossless_number()),
+         lossless_bignum_(options.lossless_bignum()),
+         index_(temp_alloc),
+         structure_stack_(temp_alloc),
+         buffer_(temp_alloc)
+    {
+        if (options.enable_str_to_nan())
+        {
+            string_double_map_.emplace_back(options.nan_to_str(),std::nan(""));
+        }
+        if (options.enable_str_to_inf())
+        {
+            string_double_map_.emplace_back(options.inf_to_str(),std::numeric_limits<double>::infinity());
+        }
+        if (options.enable_str_to_neginf())
+        {
+            string_double_map_.emplace_back(options.neginf_to_str(),-std::numeric_limits<double>::infinity());
+        }
+    }
+
+    void parse(const char_type* data, std::size_t length, basic_json_visitor<char_type>& visitor)
+    {
+        std::error_code ec;
+        parse(data, length, visitor, ec);
+        if (JSONCONS_UNLIKELY(ec))
+        {
+            JSONCONS_THROW(ser_error(ec,line(),column()));
+        }
+    }
+
+    void parse(const char_type* data, std::size_t length, basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    {
+        initialize(data, length);
+        if (length >= max_length || !build_index())
+        {
+            parse_incrementally(visitor, ec);
+            return;
+        }
+        walk_index(visitor, ec);
+    }
+
+    // Returns false, without writing to the buffer or sending any events, if the text is
+    // of a kind that is handed to basic_json_parser
+    bool parse_in_situ(char_type* data, std::size_t length, basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    {
+        initialize(data, length);
+        if (length >= max_length || !build_index())
+        {
+            return false;
+        }
+        in_situ_data_ = data;
+        walk_index(visitor, ec);
+        in_situ_data_ = nullptr;
+        return true;
+    }
+
+    std::size_t line() const override
+    {
+        // A "\r\n" pair, a lone '\r' or a lone '\n' ends a line
+        std::size_t end = (std::min)(position_, length_);
+        for (std::size_t i = line_scan_position_; i < end; ++i)
+        {
+            if (data_[i] == '\r' || (data_[i] == '\n' && (i == 0 || data_[i-1] != '\r')))
+            {
+                ++line_;
+                mark_position_ = (data_[i] == '\r' && i+1 < length_ && data_[i+1] == '\n') ? i + 2 : i + 1;
+            }
+        }
+        line_scan_position_ = (std::max)(line_scan_position_, end);
+        return line_;
+    }
+
+    std::size_t column() const override
+    {
+        line();
+        return position_ >= mark_position_ ? (position_ - mark_position_) + 1 : 1;
+    }
+
+    std::size_t begin_position() const override
+    {
+        return begin_position_;
+    }
+
+    std::size_t position() const override
+    {
+        return begin_position_;
+    }
+
+    std::size_t end_position() const override
+    {
+        return position_;
+    }
+
+private:
+
+    void initialize(const char_type* data, std::size_t length)
+    {
+        data_ = data;
+        length_ = length;
+        begin_position_ = 0;
+        position_ = 0;
+        line_scan_position_ = 0;
+        line_ = 1;
+        mark_position_ = 0;
+        index_.clear();
+        structure_stack_.clear();
+    }
+
+    void parse_incrementally(basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    {
+        basic_json_parser<char_type,TempAlloc> parser(options_, temp_alloc_);
+        parser.update(data_, length_);
+        parser.parse_some(visitor, ec);
+        if (!ec)
+        {
+            parser.finish_parse(visitor, ec);
+        }
+        if (!ec)
+        {
+            parser.check_done(ec);
+        }
+        begin_position_ = parser.begin_position();
+        position_ = parser.end_position();
+    }
+
+    // Stage one. Returns false if the text is to be parsed by basic_json_parser instead.
+    bool build_index()
+    {
+        std::size_t capacity = length_ / 4 + block_size;
+        if (index_.capacity() < capacity)
+        {
+            index_.reserve(capacity);
+        }
+
+        uint64_t escape_carry = 0;  // 1 if the first character of the next block is escaped
+        uint64_t string_carry = 0;  // all ones if the next block starts inside a string
+        uint64_t scalar_carry = 0;  // 1 if the last character of the previous block was part of a number or literal
+        uint32_t string_flags = 0;  // the flags of a string continued from the previous block
+
+        char_type padded[block_size];
+        for (std::size_t base = 0; base < length_; base += block_size)
+        {
+            const char_type* p = data_ + base;
+            if (length_ - base < block_size)
+            {
+                std::size_t n = length_ - base;
+                std::memcpy(padded, p, n*sizeof(char_type));
+                for (std::size_t i = n; i < block_size; ++i)
+                {
+                    padded[i] = ' ';
+                }
+                p = padded;
+            }
+            detail::structural_block block;
+            detail::classify_block(p, block);
+
+            // A backslash escapes the next character unless it is itself escaped
+            uint64_t escaped = escape_carry;
+            uint64_t escapes = block.backslash & ~escaped;
+            escape_carry = 0;
+            while (escapes != 0)
+            {
+                int i = detail::lowest_bit(escapes);
+                if (i == 63)
+                {
+                    escape_carry = 1;
+                    break;
+                }
+                escaped |= uint64_t(1) << (i + 1);
+                escapes &= ~(uint64_t(3) << i);
+            }
+
+            uint64_t quotes = block.quote & ~escaped;
+            // Set from an opening quote up to, but not including, its closing quote
+            uint64_t in_string = detail::prefix_xor(quotes) ^ string_carry;
+            if (JSONCONS_UNLIKELY((block.slash & ~in_string) != 0))
+            {
+                return false;
+            }
+            uint64_t scalar = ~(block.space | block.op | quotes | in_string);
+            uint64_t scalar_starts = scalar & ~((scalar << 1) | scalar_carry);
+            uint64_t escapes_in_string = (block.backslash | block.control) & in_string;
+            uint64_t high_in_string = block.high & in_string;
+            uint64_t structurals = (block.op & ~in_string) | quotes | scalar_starts;
+
+            // Bits of the current string after its opening quote
+            uint64_t string_bits = string_carry;
+            while (structurals != 0)
+            {
+                int i = detail::lowest_bit(structurals);
+                uint64_t bit = uint64_t(1) << i;
+                structurals &= structurals - 1;
+                uint32_t position = static_cast<uint32_t>(base + i);
+                if ((quotes & bit) != 0)
+                {
+                    if ((in_string & bit) != 0)
+                    {
+                        string_bits = ~((bit << 1) - 1);
+                        string_flags = 0;
+                    }
+                    else
+                    {
+                        position |= string_flags;
+                        if ((escapes_in_string & string_bits & (bit - 1)) != 0)
+                        {
+                            position |= escaped_string_flag;
+                        }
+                        if ((high_in_string & string_bits & (bit - 1)) != 0)
+                        {
+                            position |= non_ascii_string_flag;
+                        }
+                    }
+                }
+                index_.push_back(position);
+            }
+            string_carry = uint64_t(0) - (in_string >> 63);
+            if (string_carry != 0)
+            {
+                if ((escapes_in_string & string_bits) != 0)
+                {
+                    string_flags |= escaped_string_flag;
+                }
+                if ((high_in_string & string_bits) != 0)
+                {
+                    string_flags |= non_ascii_string_flag;
+                }
+            }
+            scalar_carry = scalar >> 63;
+        }
+        // an unterminated string
+        return string_carry == 0;
+    }
+
+    // Stage two
+    void walk_index(basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    {
+        const std::size_t count = index_.size();
+        std::size_t k = 0;
+        int level = 0;
+
+        if (count == 0)
+        {
+            position_ = length_;
+            ec = json_errc::unexpected_eof;
+            return;
+        }
+
+expect_value:
+        {
+            if (JSONCONS_UNLIKELY(k == count))
+            {
+                position_ = length_;
+                ec = json_errc::unexpected_eof;
+                return;
+            }
+            std::size_t pos = index_[k];
+            begin_position_ = pos;
+            position_ = pos + 1;
+            switch (data_[pos])
+            {
+                case '{':
+                    if (JSONCONS_UNLIKELY(++level > max_nesting_depth_))
+                    {
+                        ec = json_errc::max_nesting_depth_exceeded;
+                        return;
+                    }
+                    visitor.begin_object(semantic_tag::none, *this, ec);
+                    if (JSONCONS_UNLIKELY(ec)) {return;}
+                    structure_stack_.push_back(structure_kind::object);
+                    ++k;
+                    if (k < count && data_[index_[k]] == '}')
+                    {
+                        goto end_structure;
+                    }
+                    goto expect_member_name;
+                case '[':
+                    if (JSONCONS_UNLIKELY(++level > max_nesting_depth_))
+                    {
+                        ec = json_errc::max_nesting_depth_exceeded;
+                        return;
+                    }
+                    visitor.begin_array(semantic_tag::none, *this, ec);
+                    if (JSONCONS_UNLIKELY(ec)) {return;}
+                    structure_stack_.push_back(structure_kind::array);
+                    ++k;
+                    if (k < count && data_[index_[k]] == ']')
+                    {
+                        goto end_structure;
+                    }
+                    goto expect_value;
+                case '\"':
+                    string_value(k, false, visitor, ec);
+                    if (JSONCONS_UNLIKELY(ec)) {return;}
+                    k += 2;
+                    goto after_value;
+                case '}':
+                case ']':
+                case ':':
+                case ',':
+                    ec = json_errc::expected_value;
+                    return;
+                default:
+                    scalar_value(pos, visitor, ec);
+                    if (JSONCONS_UNLIKELY(ec)) {return;}
+                    ++k;
+                    goto after_value;
+            }
+        }
+
+expect_member_name:
+        {
+            if (JSONCONS_UNLIKELY(k == count))
+            {
+                position_ = length_;
+                ec = json_errc::unexpected_eof;
+                return;
+            }
+            std::size_t pos = index_[k];
+            begin_position_ = pos;
+            position_ = pos + 1;
+            if (JSONCONS_UNLIKELY(data_[pos] != '\"'))
+            {
+                ec = json_errc::expected_key;
+                return;
+            }
+            string_value(k, true, visitor, ec);
+            if (JSONCONS_UNLIKELY(ec)) {return;}
+            k += 2;
+            if (JSONCONS_UNLIKELY(k == count || data_[index_[k]] != ':'))
+            {
+                position_ = k == count ? length_ : index_[k];
+                ec = k == count ? json_errc::unexpected_eof : json_errc::expected_colon;
+                return;
+            }
+            ++k;
+            goto expect_value;
+        }
+
+after_value:
+        {
+            if (structure_stack_.empty())
+            {
+                if (JSONCONS_UNLIKELY(k != count))
+                {
+                    begin_position_ = position_ = index_[k];
+                    ec = json_errc::extra_character;
+                    return;
+                }
+                visitor.flush();
+                return;
+            }
+            if (JSONCONS_UNLIKELY(k == count))
+            {
+                position_ = length_;
+                ec = json_errc::unexpected_eof;
+                return;
+            }
+            std::size_t pos = index_[k];
+            begin_position_ = pos;
+            position_ = pos + 1;
+            switch (data_[pos])
+            {
+                case ',':
+                    ++k;
+                    if (allow_trailing_comma_ && k < count &&
+                        data_[index_[k]] == (structure_stack_.back() == structure_kind::object ? '}' : ']'))
+                    {
+                        goto end_structure;
+                    }
+                    if (structure_stack_.back() == structure_kind::object)
+                    {
+                        goto expect_member_name;
+                    }
+                    goto expect_value;
+                case '}':
+                case ']':
+                    goto end_structure;
+                default:
+                    ec = structure_stack_.back() == structure_kind::object ? json_errc::expected_comma_or_rbrace : json_errc::expected_comma_or_rbracket;
+                    return;
+            }
+        }
+
+end_structure:
+        {
+            std::size_t pos = index_[k];
+            begin_position_ = pos;
+            position_ = pos + 1;
+            if (structure_stack_.back() == structure_kind::object)
+            {
+                if (JSONCONS_UNLIKELY(data_[pos] != '}'))
+                {
+                    ec = json_errc::expected_comma_or_rbrace;
+                    return;
+                }
+                visitor.end_object(*this, ec);
+            }
+            else
+            {
+                if (JSONCONS_UNLIKELY(data_[pos] != ']'))
+                {
+                    ec = json_errc::expected_comma_or_rbracket;
+                    return;
+                }
+                visitor.end_array(*this, ec);
+            }
+            if (JSONCONS_UNLIKELY(ec)) {return;}
+            structure_stack_.pop_back();
+            --level;
+            ++k;
+            goto after_value;
+        }
+    }
+
+    static bool is_delimiter(char_type c)
+    {
+        switch (c)
+        {
+            case ' ': case '\t': case '\n': case '\r':
+            case '{': case '}': case '[': case ']': case ':': case ',': case '\"':
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // A number, true, false or null starting at pos
+    void scalar_value(std::size_t pos, basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    {
+        const char_type* first = data_ + pos;
+        const char_type* last = data_ + length_;
+        const char_type* cur = first;
+
+        switch (*cur)
+        {
+            case 't':
+                if (last - cur >= 4 && cur[1] == 'r' && cur[2] == 'u' && cur[3] == 'e' && (last - cur == 4 || is_delimiter(cur[4])))
+                {
+                    position_ = pos + 4;
+                    visitor.bool_value(true, semantic_tag::none, *this, ec);
+                    return;
+                }
+                ec = json_errc::invalid_value;
+                return;
+            case 'f':
+                if (last - cur >= 5 && cur[1] == 'a' && cur[2] == 'l' && cur[3] == 's' && cur[4] == 'e' && (last - cur == 5 || is_delimiter(cur[5])))
+                {
+                    position_ = pos + 5;
+                    visitor.bool_value(false, semantic_tag::none, *this, ec);
+                    return;
+                }
+                ec = json_errc::invalid_value;
+                return;
+            case 'n':
+                if (last - cur >= 4 && cur[1] == 'u' && cur[2] == 'l' && cur[3] == 'l' && (last - cur == 4 || is_delimiter(cur[4])))
+                {
+                    position_ = pos + 4;
+                    visitor.null_value(semantic_tag::none, *this, ec);
+                    return;
+                }
+                ec = json_errc::invalid_value;
+                return;
+            default:
+                break;
+        }
+
+        // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+        bool is_integer = true;
+        if (*cur == '-')
+        {
+            ++cur;
+        }
+        if (cur < last && *cur == '0')
+        {
+            ++cur;
+        }
+        else if (cur < last && jsoncons::is_nonzero_digit(*cur))
+        {
+            ++cur;
+            while (cur < last && jsoncons::is_digit(*cur))
+            {
+                ++cur;
+            }
+        }
+        else
+        {
+            ec = cur == first ? json_errc::syntax_error : json_errc::invalid_number;
+            return;
+        }
+        if (cur < last && *cur == '.')
+        {
+            ++cur;
+            if (JSONCONS_UNLIKELY(!(cur < last && jsoncons::is_digit(*cur))))
+            {
+                ec = json_errc::invalid_number;
+                return;
+            }
+            while (cur < last && jsoncons::is_digit(*cur))
+            {
+                ++cur;
+            }
+            is_integer = false;
+        }
+        if (cur < last && jsoncons::is_exp(*cur))
+        {
+            ++cur;
+            if (cur < last && (*cur == '+' || *cur == '-'))
+            {
+                ++cur;
+            }
+            if (JSONCONS_UNLIKELY(!(cur < last && jsoncons::is_digit(*cur))))
+            {
+                ec = json_errc::invalid_number;
+                return;
+            }
+            while (cur < last && jsoncons::is_digit(*cur))
+            {
+                ++cur;
+            }
+            is_integer = false;
+        }
+        position_ = pos + (cur - first);
+        if (JSONCONS_UNLIKELY(cur < last && !is_delimiter(*cur)))
+        {
+            ec = json_errc::invalid_number;
+            return;
+        }
+
+        std::size_t length = cur - first;
+        // the text of a number that ends the input is copied, as it must be followed by a terminator
+        if (cur == last)
+        {
+            buffer_.assign(first, length);
+            first = buffer_.data();
+        }
+        if (is_integer)
+        {
+            integer_value(first, length, visitor, ec);
+        }
+        else
+        {
+            fraction_value(first, length, visitor, ec);
+        }
+    }
+
+    void integer_value(const char_type* s, std::size_t length, basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    {
+        if (*s == '-')
+        {
+            int64_t val;
+            if (jsoncons::dec_to_integer(s, length, val))
+            {
+                visitor.int64_value(val, semantic_tag::none, *this, ec);
+                return;
+            }
+        }
+        else
+        {
+            uint64_t val;
+            if (jsoncons::dec_to_integer(s, length, val))
+            {
+                visitor.uint64_value(val, semantic_tag::none, *this, ec);
+                return;
+            }
+        }
+        // Must be overflow
+        if (lossless_bignum_)
+        {
+            visitor.string_value(string_view_type(s, length), semantic_tag::bigint, *this, ec);
+            return;
+        }
+        double d{0};
+        auto result = jsoncons::dec_to_double(s, length, d);
+        if (JSONCONS_LIKELY(result))
+        {
+            visitor.double_value(d, semantic_tag::none, *this, ec);
+        }
+        else if (result.ec == std::errc::result_out_of_range)
+        {
+            visitor.double_value(d, semantic_tag{}, *this, ec); // REVISIT
+        }
+        else
+        {
+            ec = json_errc::invalid_number;
+        }
+    }
+
+    void fraction_value(const char_type* s, std::size_t length, basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    {
+        if (lossless_number_)
+        {
+            visitor.string_value(string_view_type(s, length), semantic_tag::bigdec, *this, ec);
+            return;
+        }
+        double d{0};
+        auto result = jsoncons::dec_to_double(s, length, d);
+        if (JSONCONS_LIKELY(result))
+        {
+            visitor.double_value(d, semantic_tag::none, *this, ec);
+        }
+        else if (result.ec == std::errc::result_out_of_range)
+        {
+            if (lossless_bignum_)
+            {
+                visitor.string_value(string_view_type(s, length), semantic_tag::bigdec, *this, ec);
+            }
+            else
+            {
+                visitor.double_value(d, semantic_tag{}, *this, ec); // REVISIT
+            }
+        }
+        else
+        {
+            ec = json_errc::invalid_number;
+        }
+    }
+
+    // The string whose opening quote is index_[k], and closing quote index_[k+1]
+    void string_value(std::size_t k, bool is_key, basic_json_visitor<char_type>& visitor, std::error_code& ec)
+    {
+        std::size_t open = index_[k];
+        uint32_t close = index_[k+1];
+        const char_type* first = data_ + open + 1;
+        const char_type* last = data_ + (close & position_mask);
+        position_ = (close & position_mask) + 1;
+
+        string_view_type sv(first, last - first);
+        semantic_tag tag = semantic_tag::noesc;
+        if (JSONCONS_UNLIKELY((close & escaped_string_flag) != 0))
+        {
+            bool non_ascii = false;
+            bool escaped = false;
+            const char_type* sb = first;
+            const char_type* cur = first;
+            buffer_.clear();
+            while (true)
+            {
+                cur = detail::skip_string_text(cur, last, non_ascii);
+                if (cur == last)
+                {
+                    break;
+                }
+                switch (*cur)
+                {
+                    case '\\':
+                        buffer_.append(sb, cur - sb);
+                        escaped = true;
+                        cur = unescape(cur + 1, last, non_ascii, ec);
+                        if (JSONCONS_UNLIKELY(ec)) {return;}
+                        sb = cur;
+                        break;
+                    JSONCONS_ILLEGAL_CONTROL_CHARACTER:
+                        position_ = (cur - data_) + 1;
+                        ec = json_errc::illegal_control_character;
+                        return;
+                    case '\n':
+                    case '\r':
+                    case '\t':
+                        position_ = (cur - data_) + 1;
+                        ec = json_errc::illegal_character_in_string;
+                        return;
+                    default:
+                        ++cur;
+                        break;
+                }
+            }
+            if (escaped)
+            {
+                buffer_.append(sb, last - sb);
+                sv = string_view_type(buffer_.data(), buffer_.length());
+                tag = semantic_tag{};
+            }
+            // text that is all ASCII is valid UTF-8
+            if (non_ascii)
+            {
+                auto result = unicode_traits::validate(sv.data(), sv.size());
+                if (result.ec != unicode_traits::conv_errc())
+                {
+                    translate_conv_errc(result.ec, ec);
+                    return;
+                }
+            }
+        }
+        else if ((close & non_ascii_string_flag) != 0)
+        {
+            auto result = unicode_traits::validate(sv.data(), sv.size());
+            if (result.ec != unicode_traits::conv_errc())
+            {
+                translate_conv_errc(result.ec, ec);
+                return;
+            }
+        }
+
+        if (in_situ_data_ != nullptr)
+        {
+            char_type* p = in_situ_data_ + open + 1;
+            if (sv.data() != first)
+            {
+                // count the line breaks before the escapes are overwritten, so that line() stays right
+                line();
+                std::memcpy(p, sv.data(), sv.size()*sizeof(char_type));
+            }
+            p[sv.size()] = 0;
+            sv = string_view_type(p, sv.size());
+        }
+
+        if (is_key)
+        {
+            visitor.key(sv, *this, ec);
+            return;
+        }
+        auto it = std::find_if(string_double_map_.begin(), string_double_map_.end(), string_maps_to_double{ sv });
+        if (it != string_double_map_.end())
+        {
+            visitor.double_value((*it).second, semantic_tag::none, *this, ec);
+        }
+        else
+        {
+            visitor.string_value(sv, tag, *this, ec);
+        }
+    }
+
+    // Appends the character escaped by the sequence following a backslash at cur
+    const char_type* unescape(const char_type* cur, const char_type* last, bool& non_ascii, std::error_code& ec)
+    {
+        switch (*cur)
+        {
+            case '\"': buffer_.push_back('\"'); return cur + 1;
+            case '\\': buffer_.push_back('\\'); return cur + 1;
+            case '/': buffer_.push_back('/'); return cur + 1;
+            case 'b': buffer_.push_back('\b'); return cur + 1;
+            case 'f': buffer_.push_back('\f'); return cur + 1;
+            case 'n': buffer_.push_back('\n'); return cur + 1;
+            case 'r': buffer_.push_back('\r'); return cur + 1;
+            case 't': buffer_.push_back('\t'); return cur + 1;
+            case 'u':
+                break;
+            default:
+                position_ = cur - data_;
+                ec = json_errc::illegal_escaped_character;
+                return cur;
+        }
+        // the escaped code point may be appended as several UTF-8 bytes
+        non_ascii = true;
+        uint32_t cp = 0;
+        cur = read_codepoint(cur + 1, last, cp, ec);
+        if (JSONCONS_UNLIKELY(ec)) {return cur;}
+        if (unicode_traits::is_high_surrogate(cp))
+        {
+            if (JSONCONS_UNLIKELY(last - cur < 2 || cur[0] != '\\' || cur[1] != 'u'))
+            {
+                position_ = cur - data_;
+                ec = json_errc::expected_codepoint_surrogate_pair;
+                return cur;
+            }
+            uint32_t cp2 = 0;
+            cur = read_codepoint(cur + 2, last, cp2, ec);
+            if (JSONCONS_UNLIKELY(ec)) {return cur;}
+            cp = 0x10000 + ((cp & 0x3FF) << 10) + (cp2 & 0x3FF);
+        }
+        unicode_traits::convert(&cp, 1, buffer_);
+        return cur;
+    }
+
+    const char_type* read_codepoint(const char_type* cur, const char_type* last, uint32_t& cp, std::error_code& ec)
+    {
+        for (int i = 0; i < 4; ++i, ++cur)
+        {
+            int c = cur < last ? static_cast<int>(*cur) : 0;
+            cp *= 16;
+            if (c >= '0' && c <= '9')
+            {
+                cp += c - '0';
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                cp += c - 'a' + 10;
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                cp += c - 'A' + 10;
+            }
+            else
+            {
+                position_ = cur - data_;
+                ec = json_errc::invalid_unicode_escape_sequence;
+                return cur;
+            }
+        }
+        return cur;
+    }
+
+    void translate_conv_errc(unicode_traits::conv_errc result, std::error_code& ec)
+    {
+        switch (result)
+        {
+            case unicode_traits::conv_errc::over_long_utf8_sequence:
+                ec = json_errc::over_long_utf8_sequence;
+                break;
+            case unicode_traits::conv_errc::unpaired_high_surrogate:
+                ec = json_errc::unpaired_high_surrogate;
+                break;
+            case unicode_traits::conv_errc::expected_continuation_byte:
+                ec = json_errc::expected_continuation_byte;
+                break;
+            case unicode_traits::conv_errc::illegal_surrogate_value:
+                ec = json_errc::illegal_surrogate_value;
+                break;
+            default:
+                ec = json_errc::illegal_codepoint;
+                break;
+        }
+    }
+};
+
+using json_structural_parser = basic_json_structural_parser<char>;
+using wjson_structural_parser = basic_json_structural_parser<wchar_t>;
+
+}
+
+#endif
@@ -170,6 +170,13 @@ namespace jsoncons {
     
     JSONCONS_INLINE_CONSTEXPR json_pointer_arg_t json_pointer_arg{};
 
+    struct string_view_arg_t
+    {
+        explicit string_view_arg_t() = default; 
+    };
+    
+    JSONCONS_INLINE_CONSTEXPR string_view_arg_t string_view_arg{};
+
     struct raw_json_arg_t
     {
         explicit raw_json_arg_t() = default; 
@@ -194,6 +201,7 @@ namespace jsoncons {
         short_str = 7,            // 0111
         json_const_ref = 8, // 1000    
         json_ref = 9,       // 1001    
+        str_view = 10,            // 1010
         byte_str = 12,            // 1100  
         object = 13,              // 1101
         array = 14,               // 1110
@@ -203,7 +211,7 @@ namespace jsoncons {
     inline bool is_string_storage(json_storage_kind storage_kind) noexcept
     {
         static const uint8_t mask{ uint8_t(json_storage_kind::short_str) & uint8_t(json_storage_kind::long_str) };
-        return (uint8_t(storage_kind) & mask) == mask;
+        return (uint8_t(storage_kind) & mask) == mask || storage_kind == json_storage_kind::str_view;
     }
 
     inline bool is_trivial_storage(json_storage_kind storage_kind) noexcept
@@ -224,6 +232,7 @@ namespace jsoncons {
         static constexpr const CharT* double_value = JSONCONS_CSTRING_CONSTANT(CharT, "double");
         static constexpr const CharT* short_string_value = JSONCONS_CSTRING_CONSTANT(CharT, "short_string");
         static constexpr const CharT* long_string_value = JSONCONS_CSTRING_CONSTANT(CharT, "string");
+        static constexpr const CharT* string_view_value = JSONCONS_CSTRING_CONSTANT(CharT, "string_view");
         static constexpr const CharT* byte_string_value = JSONCONS_CSTRING_CONSTANT(CharT, "byte_string");
         static constexpr const CharT* array_value = JSONCONS_CSTRING_CONSTANT(CharT, "array");
         static constexpr const CharT* empty_object_value = JSONCONS_CSTRING_CONSTANT(CharT, "empty_object");
@@ -273,6 +282,11 @@ namespace jsoncons {
                 os << long_string_value;
                 break;
             }
+            case json_storage_kind::str_view:
+            {
+                os << string_view_value;
+                break;
+            }
             case json_storage_kind::byte_str:
             {
                 os << byte_string_value;
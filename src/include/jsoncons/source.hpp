@@ -712,6 +712,16 @@ namespace jsoncons {
             return span<const value_type>(data, length);
         }
 
+        // Returns a view of the next length bytes (fewer at end of input) without copying them
+        span<const value_type> read_span(std::size_t length)
+        {
+            const value_type* data = current_;
+            std::size_t len = (std::min)(length, std::size_t(end_ - current_));
+            current_ += len;
+
+            return span<const value_type>(data, len);
+        }
+
         std::size_t read(value_type* p, std::size_t length)
         {
             std::size_t len;
@@ -843,6 +853,13 @@ namespace jsoncons {
         }
     };
 
+    template <typename Source>
+    using source_read_span_t = decltype(std::declval<Source>().read_span(std::size_t()));
+
+    // Sources over contiguous memory that can hand out views instead of copies
+    template <typename Source>
+    using has_read_span = ext_traits::is_detected<source_read_span_t, Source>;
+
     template <typename Source>
     struct source_reader
     {
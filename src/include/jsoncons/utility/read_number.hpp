@@ -10,6 +10,7 @@
 #include <cctype>
 #include <cstddef>
 #include <cstdint>
+#include <cstring> // std::memcpy
 #include <locale>
 #include <stdexcept>
 #include <string>
@@ -19,7 +20,9 @@
 
 #include <jsoncons/config/compiler_support.hpp>
 #include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/detail/eisel_lemire.hpp>
 #include <jsoncons/json_exception.hpp>
+#include <jsoncons/utility/binary.hpp>
 #include <jsoncons/utility/more_type_traits.hpp>
 
 namespace jsoncons { 
@@ -128,6 +131,35 @@ constexpr bool is_digit_or_fp(wchar_t d) {
     return is_digit(d) || is_fp(d);
 }
 
+// Reads eight ASCII digits at p as one 64-bit word and converts them with three multiplications
+// (SWAR, SIMD within a register). Returns false, leaving value unchanged, if any of the 
+// eight characters is not a digit. 
+inline bool read_eight_digits(const char* p, uint32_t& value)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    JSONCONS_IF_CONSTEXPR (endian::native == endian::big)
+    {
+        v = binary::byte_swap(v);
+    }
+    if ((((v + 0x4646464646464646) | (v - 0x3030303030303030)) & 0x8080808080808080) != 0)
+    {
+        return false;
+    }
+    v -= 0x3030303030303030;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FF) * 0x000F424000000064) + 
+         (((v >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >> 32;
+    value = static_cast<uint32_t>(v);
+    return true;
+}
+
+template <typename CharT>
+bool read_eight_digits(const CharT*, uint32_t&)
+{
+    return false;
+}
+
 template <typename CharT>
 struct to_number_result
 {
@@ -277,7 +309,16 @@ dec_to_integer(const CharT* s, std::size_t length, T& value)
     static constexpr std::size_t digits10 = static_cast<std::size_t>(ext_traits::integer_limits<T>::digits10);
     const std::size_t n = (std::min)(digits10, length);
     const CharT* stop = s + n;
-     
+
+    JSONCONS_IF_CONSTEXPR (digits10 >= 8)
+    {
+        uint32_t eight;
+        while (stop - cur >= 8 && read_eight_digits(cur, eight))
+        {
+            num = static_cast<T>(num*100000000u + eight);
+            cur += 8;
+        }
+    }
     while (cur < stop)
     {
         uint8_t d;
@@ -1031,6 +1072,111 @@ inline to_number_result<wchar_t> hexstr_to_double(const wchar_t* s, std::size_t
     }
     return to_number_result<wchar_t>{str_end};
 }
+
+// Converts a JSON number with at most 19 significant digits by accumulating the digits eight at 
+// a time and rounding with detail::decimal_to_double, and anything else, including input 
+// decimal_to_double cannot round, with decstr_to_double.
+template <typename CharT>
+to_number_result<CharT> dec_to_double(const CharT* s, std::size_t length, double& val)
+{
+    const CharT* cur = s;
+    const CharT* last = s + length;
+
+    bool negative = cur < last && *cur == '-';
+    if (negative)
+    {
+        ++cur;
+    }
+    const CharT* digits_begin = cur;
+    uint64_t w = 0;
+    uint32_t eight;
+    while (last - cur >= 8 && read_eight_digits(cur, eight))
+    {
+        w = w*100000000u + eight;
+        cur += 8;
+    }
+    while (cur < last && is_digit(*cur))
+    {
+        w = w*10 + static_cast<uint64_t>(*cur - '0');
+        ++cur;
+    }
+    std::ptrdiff_t digit_count = cur - digits_begin;
+    if (JSONCONS_UNLIKELY(digit_count == 0))
+    {
+        return decstr_to_double(s, length, val);
+    }
+
+    int64_t exponent = 0;
+    if (cur < last && *cur == '.')
+    {
+        ++cur;
+        const CharT* fraction_begin = cur;
+        while (last - cur >= 8 && read_eight_digits(cur, eight))
+        {
+            w = w*100000000u + eight;
+            cur += 8;
+        }
+        while (cur < last && is_digit(*cur))
+        {
+            w = w*10 + static_cast<uint64_t>(*cur - '0');
+            ++cur;
+        }
+        if (JSONCONS_UNLIKELY(cur == fraction_begin))
+        {
+            return decstr_to_double(s, length, val);
+        }
+        exponent = -(cur - fraction_begin);
+        digit_count += cur - fraction_begin;
+    }
+    if (cur < last && is_exp(*cur))
+    {
+        ++cur;
+        bool negative_exponent = false;
+        if (cur < last && (*cur == '-' || *cur == '+'))
+        {
+            negative_exponent = *cur == '-';
+            ++cur;
+        }
+        if (JSONCONS_UNLIKELY(cur == last || !is_digit(*cur)))
+        {
+            return decstr_to_double(s, length, val);
+        }
+        int64_t e = 0;
+        while (cur < last && is_digit(*cur))
+        {
+            if (e < 0x10000)
+            {
+                e = e*10 + (*cur - '0');
+            }
+            ++cur;
+        }
+        exponent += negative_exponent ? -e : e;
+    }
+    if (JSONCONS_UNLIKELY(cur != last))
+    {
+        return decstr_to_double(s, length, val);
+    }
+    if (digit_count > 19)
+    {
+        // Leading zeros, as in 0.000123, are not significant
+        for (const CharT* p = digits_begin; p < last && (*p == '0' || *p == '.'); ++p)
+        {
+            if (*p == '0')
+            {
+                --digit_count;
+            }
+        }
+        if (digit_count > 19)
+        {
+            return decstr_to_double(s, length, val);
+        }
+    }
+    if (JSONCONS_UNLIKELY(!detail::decimal_to_double(w, exponent, negative, val)))
+    {
+        return decstr_to_double(s, length, val);
+    }
+    return to_number_result<CharT>(last, std::errc{});
+}
         
 } // namespace jsoncons
 
@@ -20,7 +20,7 @@
 
 #include <jsoncons/config/compiler_support.hpp>
 #include <jsoncons/config/jsoncons_config.hpp>
-#include <jsoncons/detail/grisu3.hpp>
+#include <jsoncons/detail/schubfach.hpp>
 #include <jsoncons/utility/read_number.hpp>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_options.hpp>
@@ -364,6 +364,8 @@ bool dtoa_general(double val, char decimal_point, Result& result, std::false_typ
 template <typename Result>
 bool dtoa_general(double v, char decimal_point, Result& result, std::true_type)
 {
+    (void)decimal_point; // prettify_string always writes '.'
+
     if (v == 0)
     {
         result.push_back('0');
@@ -378,21 +380,15 @@ bool dtoa_general(double v, char decimal_point, Result& result, std::true_type)
     char buffer[100];
 
     double u = std::signbit(v) ? -v : v;
-    if (jsoncons::detail::grisu3(u, buffer, &length, &k))
+    jsoncons::detail::schubfach(u, buffer, &length, &k);
+    if (std::signbit(v))
     {
-        if (std::signbit(v))
-        {
-            result.push_back('-');
-        }
-        // min exp: -4 is consistent with sprintf
-        // max exp: std::numeric_limits<double>::max_digits10
-        jsoncons::prettify_string(buffer, length, k, -4, std::numeric_limits<double>::max_digits10, result);
-        return true;
-    }
-    else
-    {
-        return dtoa_general(v, decimal_point, result, std::false_type());
+        result.push_back('-');
     }
+    // min exp: -4 is consistent with sprintf
+    // max exp: std::numeric_limits<double>::max_digits10
+    jsoncons::prettify_string(buffer, length, k, -4, std::numeric_limits<double>::max_digits10, result);
+    return true;
 }
 
 template <typename Result>
@@ -435,6 +431,8 @@ bool dtoa_fixed(double val, char decimal_point, Result& result, std::false_type)
 template <typename Result>
 bool dtoa_fixed(double v, char decimal_point, Result& result, std::true_type)
 {
+    (void)decimal_point; // prettify_string always writes '.'
+
     if (v == 0)
     {
         result.push_back('0');
@@ -449,19 +447,13 @@ bool dtoa_fixed(double v, char decimal_point, Result& result, std::true_type)
     char buffer[100];
 
     double u = std::signbit(v) ? -v : v;
-    if (jsoncons::detail::grisu3(u, buffer, &length, &k))
+    jsoncons::detail::schubfach(u, buffer, &length, &k);
+    if (std::signbit(v))
     {
-        if (std::signbit(v))
-        {
-            result.push_back('-');
-        }
-        jsoncons::prettify_string(buffer, length, k, std::numeric_limits<int>::lowest(), (std::numeric_limits<int>::max)(), result);
-        return true;
-    }
-    else
-    {
-        return dtoa_fixed(v, decimal_point, result, std::false_type());
+        result.push_back('-');
     }
+    jsoncons::prettify_string(buffer, length, k, std::numeric_limits<int>::lowest(), (std::numeric_limits<int>::max)(), result);
+    return true;
 }
 
 template <typename Result>
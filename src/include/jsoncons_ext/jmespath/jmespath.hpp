@@ -9,13 +9,18 @@
 
 #include <algorithm> // std::stable_sort, std::reverse
 #include <cmath> // std::abs
+#include <condition_variable> // std::condition_variable
 #include <cstddef>
 #include <exception>
 #include <functional> // 
 #include <limits> // std::numeric_limits
 #include <memory>
+#include <mutex> // std::mutex
+#include <new> // placement new
+#include <ostream> // std::basic_ostream
 #include <string>
 #include <system_error>
+#include <thread> // std::thread
 #include <type_traits> // std::is_const
 #include <unordered_map> // std::unordered_map
 #include <utility> // std::move
@@ -32,6 +37,11 @@
 
 #include <jsoncons_ext/jmespath/jmespath_error.hpp>
 
+// 0 runs every token list with evaluate_tokens instead of lowering it, to compare the two
+#ifndef JSONCONS_JMESPATH_LOWER_PROGRAMS
+#define JSONCONS_JMESPATH_LOWER_PROGRAMS 1
+#endif
+
 namespace jsoncons { 
 namespace jmespath {
 
@@ -80,6 +90,33 @@ namespace jmespath {
             }
         }
 
+        static const char* symbol(operator_kind oper)
+        {
+            switch (oper)
+            {
+                case operator_kind::or_op:
+                    return "||";
+                case operator_kind::and_op:
+                    return "&&";
+                case operator_kind::eq_op:
+                    return "==";
+                case operator_kind::ne_op:
+                    return "!=";
+                case operator_kind::lt_op:
+                    return "<";
+                case operator_kind::lte_op:
+                    return "<=";
+                case operator_kind::gt_op:
+                    return ">";
+                case operator_kind::gte_op:
+                    return ">=";
+                case operator_kind::not_op:
+                    return "!";
+                default:
+                    return "";
+            }
+        }
+
         static bool is_right_associative(operator_kind oper)
         {
             switch (oper)
@@ -105,6 +142,341 @@ namespace jmespath {
         }
     };
 
+    // temp_json_storage
+
+    // Owns the temporaries created while evaluating expressions on one thread. Values are placed
+    // in blocks that are kept for later evaluations, so creating a temporary bumps a counter
+    // instead of allocating. Evaluations may nest, each releases only the values it created.
+    template <typename Json>
+    class temp_json_storage
+    {
+        static constexpr std::size_t block_size = 64;
+        // blocks kept once the outermost evaluation ends
+        static constexpr std::size_t max_retained_blocks = 64;
+
+        using slot_type = typename std::aligned_storage<sizeof(Json),alignof(Json)>::type;
+
+        std::vector<std::unique_ptr<slot_type[]>> blocks_;
+        std::size_t size_{0};
+        // Storages taken over by adopt, each with the size at which it was adopted
+        std::vector<std::pair<std::size_t,std::unique_ptr<temp_json_storage>>> adopted_;
+    public:
+        temp_json_storage() = default;
+        temp_json_storage(const temp_json_storage&) = delete;
+        temp_json_storage& operator=(const temp_json_storage&) = delete;
+
+        ~temp_json_storage() noexcept
+        {
+            release(0);
+        }
+
+        static temp_json_storage& thread_instance()
+        {
+            static thread_local temp_json_storage storage;
+            return storage;
+        }
+
+        std::size_t size() const
+        {
+            return size_;
+        }
+
+        template <typename... Args>
+        Json* create(Args&& ... args)
+        {
+            if (size_ == blocks_.size()*block_size)
+            {
+                blocks_.push_back(std::unique_ptr<slot_type[]>(new slot_type[block_size]));
+            }
+            Json* ptr = ::new(static_cast<void*>(slot(size_))) Json(std::forward<Args>(args)...);
+            ++size_;
+            return ptr;
+        }
+
+        // Takes over the values of another storage, e.g. one filled on another thread, so that
+        // they live until the values created from now on are released
+        void adopt(std::unique_ptr<temp_json_storage>&& other)
+        {
+            adopted_.emplace_back(size_, std::move(other));
+        }
+
+        // Destroys the values created after the first mark ones, in reverse order of creation
+        void release(std::size_t mark) noexcept
+        {
+            while (size_ > mark)
+            {
+                --size_;
+                reinterpret_cast<Json*>(slot(size_))->~Json();
+            }
+            while (!adopted_.empty() && adopted_.back().first >= mark)
+            {
+                adopted_.pop_back();
+            }
+            if (size_ == 0 && blocks_.size() > max_retained_blocks)
+            {
+                blocks_.resize(max_retained_blocks);
+            }
+        }
+    private:
+        slot_type* slot(std::size_t i)
+        {
+            return blocks_[i / block_size].get() + i % block_size;
+        }
+    };
+
+    template <typename Json>
+    constexpr std::size_t temp_json_storage<Json>::block_size;
+    template <typename Json>
+    constexpr std::size_t temp_json_storage<Json>::max_retained_blocks;
+
+    // Releases the temporaries created during one evaluation
+    template <typename Json>
+    class temp_json_scope
+    {
+        temp_json_storage<Json>& storage_;
+        std::size_t mark_;
+    public:
+        temp_json_scope()
+            : storage_(temp_json_storage<Json>::thread_instance()), mark_(storage_.size())
+        {
+        }
+        temp_json_scope(const temp_json_scope&) = delete;
+        temp_json_scope& operator=(const temp_json_scope&) = delete;
+
+        ~temp_json_scope() noexcept
+        {
+            storage_.release(mark_);
+        }
+
+        temp_json_storage<Json>& storage()
+        {
+            return storage_;
+        }
+    };
+
+    // projection_pool
+
+    // Threads on which projections over large arrays and objects are evaluated in chunks, see
+    // projection_pool::scope. Evaluation is serial unless a pool is in scope.
+    class projection_pool
+    {
+        std::size_t threshold_;
+        std::vector<std::thread> threads_;
+
+        std::mutex run_mutex_;
+        std::mutex mutex_;
+        std::condition_variable work_cv_;
+        std::condition_variable done_cv_;
+        const std::function<void(std::size_t)>* task_{nullptr};
+        std::size_t next_{0};
+        std::size_t count_{0};
+        std::size_t pending_{0};
+        bool stop_{false};
+    public:
+        // Makes the evaluations started on the current thread while it exists use pool, which
+        // may be nullptr for serial evaluation
+        class scope
+        {
+            projection_pool* previous_;
+        public:
+            explicit scope(projection_pool* pool)
+                : previous_(current())
+            {
+                current() = pool;
+            }
+            scope(const scope&) = delete;
+            scope& operator=(const scope&) = delete;
+
+            ~scope() noexcept
+            {
+                current() = previous_;
+            }
+        };
+
+        // Starts threads workers, a projection is split once it has at least threshold elements
+        projection_pool(std::size_t threads, std::size_t threshold)
+            : threshold_((std::max)(threshold, std::size_t(1)))
+        {
+            threads_.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i)
+            {
+                threads_.emplace_back([this]() {work();});
+            }
+        }
+
+        projection_pool(const projection_pool&) = delete;
+        projection_pool& operator=(const projection_pool&) = delete;
+
+        ~projection_pool() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            work_cv_.notify_all();
+            for (auto& t : threads_)
+            {
+                t.join();
+            }
+        }
+
+        // The pool in scope on the current thread, if any
+        static projection_pool*& current()
+        {
+            static thread_local projection_pool* pool = nullptr;
+            return pool;
+        }
+
+        std::size_t threshold() const
+        {
+            return threshold_;
+        }
+
+        // Number of threads running the tasks of a run, the calling thread included
+        std::size_t concurrency() const
+        {
+            return threads_.size() + 1;
+        }
+
+        // Calls task(i) for each i < count on the workers and the calling thread, and returns
+        // once all calls have returned. Runs from several threads are taken one at a time.
+        // task must not throw.
+        void run(std::size_t count, const std::function<void(std::size_t)>& task)
+        {
+            std::lock_guard<std::mutex> run_lock(run_mutex_);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                task_ = std::addressof(task);
+                next_ = 0;
+                count_ = count;
+                pending_ = count;
+            }
+            work_cv_.notify_all();
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (next_ < count_)
+            {
+                std::size_t i = next_++;
+                lock.unlock();
+                task(i);
+                lock.lock();
+                --pending_;
+            }
+            done_cv_.wait(lock, [this]() {return pending_ == 0;});
+            task_ = nullptr;
+        }
+    private:
+        void work()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                work_cv_.wait(lock, [this]() {return stop_ || (task_ != nullptr && next_ < count_);});
+                if (stop_)
+                {
+                    return;
+                }
+                std::size_t i = next_++;
+                const auto& task = *task_;
+                lock.unlock();
+                task(i);
+                lock.lock();
+                if (--pending_ == 0)
+                {
+                    done_cv_.notify_all();
+                }
+            }
+        }
+    };
+
+    // evaluation_result
+
+    // Result of an evaluation that refers into the document, the parameters and the literals of
+    // the expression instead of copying out of them, so all of these must outlive it unchanged.
+    // Temporaries the result is built from are owned by it.
+    template <typename Json>
+    class evaluation_result
+    {
+        std::unique_ptr<temp_json_storage<Json>> storage_;
+        const Json* value_;
+    public:
+        evaluation_result()
+            : value_(std::addressof(Json::null()))
+        {
+        }
+
+        evaluation_result(std::unique_ptr<temp_json_storage<Json>>&& storage, const Json& value)
+            : storage_(std::move(storage)), value_(std::addressof(value))
+        {
+        }
+
+        evaluation_result(const evaluation_result&) = delete;
+        evaluation_result(evaluation_result&&) = default;
+        evaluation_result& operator=(const evaluation_result&) = delete;
+        evaluation_result& operator=(evaluation_result&&) = default;
+
+        // The result, arrays and objects in it may hold references to values elsewhere
+        const Json& value() const
+        {
+            return *value_;
+        }
+
+        // An independent copy of the result
+        Json copy() const
+        {
+            return deep_copy(*value_);
+        }
+    };
+
+    // parameter_schema
+
+    // Names of the parameters that expressions are evaluated with. In an expression compiled
+    // against a schema, references to these parameters are resolved to slots, and evaluate takes
+    // the parameter values in slot order instead of a map of variables.
+    template <typename Json>
+    class parameter_schema
+    {
+    public:
+        using char_type = typename Json::char_type;
+        using char_traits_type = typename Json::char_traits_type;
+        using string_type = std::basic_string<char_type,char_traits_type>;
+        using string_view_type = typename Json::string_view_type;
+    private:
+        std::vector<string_type> names_;
+    public:
+        // Returns the slot of name, declaring it first if needed
+        std::size_t add(const string_view_type& name)
+        {
+            std::size_t slot = find(name);
+            if (slot == names_.size())
+            {
+                names_.emplace_back(name.data(), name.size());
+            }
+            return slot;
+        }
+
+        // Returns the slot of name, or size() if it is not declared
+        std::size_t find(const string_view_type& name) const
+        {
+            std::size_t slot = 0;
+            while (slot < names_.size() && string_view_type(names_[slot]) != name)
+            {
+                ++slot;
+            }
+            return slot;
+        }
+
+        std::size_t size() const
+        {
+            return names_.size();
+        }
+
+        const string_type& name(std::size_t slot) const
+        {
+            return names_[slot];
+        }
+    };
+
     // eval_context
 
     template <typename Json>
@@ -118,37 +490,104 @@ namespace jmespath {
         using reference = typename Json::const_reference;
         using pointer = typename Json::pointer;
     public:
-        std::vector<std::unique_ptr<Json>>& temp_storage_;
-        std::map<string_type,const Json*> variables_;
+        temp_json_storage<Json>& temp_storage_;
+    private:
+        // Enclosing scope, its variables are visible here unless set again in this scope
+        const eval_context* parent_{nullptr};
+        // Variables set in this scope, a scope binds few of them so a vector beats a map
+        std::vector<std::pair<string_type,const Json*>> variables_;
+        // Parameter values in slot order, shared by all scopes of an evaluation
+        const parameter_schema<Json>* schema_{nullptr};
+        jsoncons::span<const Json> params_;
+        projection_pool* pool_{projection_pool::current()};
 
     public:
-        eval_context(std::vector<std::unique_ptr<Json>>& temp_storage)
+        eval_context(temp_json_storage<Json>& temp_storage)
             : temp_storage_(temp_storage)
         {
         }
 
-        eval_context(std::vector<std::unique_ptr<Json>>& temp_storage, 
+        eval_context(temp_json_storage<Json>& temp_storage, 
             const std::map<string_type,const Json*>& variables)
-            : temp_storage_(temp_storage), variables_(variables)
+            : temp_storage_(temp_storage), variables_(variables.begin(), variables.end())
+        {
+        }
+
+        eval_context(temp_json_storage<Json>& temp_storage, 
+            const parameter_schema<Json>& schema, jsoncons::span<const Json> params)
+            : temp_storage_(temp_storage), schema_(std::addressof(schema)), params_(params)
+        {
+        }
+
+        // Child scope of parent, which must outlive it. Creating it does not copy the parent's variables.
+        eval_context(temp_json_storage<Json>& temp_storage, const eval_context& parent)
+            : temp_storage_(temp_storage), parent_(std::addressof(parent)), 
+              schema_(parent.schema_), params_(parent.params_), pool_(parent.pool_)
+        {
+        }
+
+        // Child scope of parent evaluated with pool instead, e.g. nullptr within a chunk already
+        // evaluated on a pool thread
+        eval_context(temp_json_storage<Json>& temp_storage, const eval_context& parent, projection_pool* pool)
+            : temp_storage_(temp_storage), parent_(std::addressof(parent)), 
+              schema_(parent.schema_), params_(parent.params_), pool_(pool)
+        {
+        }
+
+        // Pool for projections over at least its threshold of elements, nullptr if evaluation is serial
+        projection_pool* pool() const
         {
+            return pool_;
         }
         
         ~eval_context() noexcept = default;
         
         void set_variable(const string_type& key, const Json& value)
         {
-            variables_[key] = std::addressof(value);
+            for (auto& item : variables_)
+            {
+                if (item.first == key)
+                {
+                    item.second = std::addressof(value);
+                    return;
+                }
+            }
+            variables_.emplace_back(key, std::addressof(value));
         }
         
         const Json& get_variable(const string_type& key, std::error_code& ec) const
         {
-            auto it = variables_.find(key);
-            if (it == variables_.end())
+            for (const eval_context* scope = this; scope != nullptr; scope = scope->parent_)
+            {
+                for (const auto& item : scope->variables_)
+                {
+                    if (item.first == key)
+                    {
+                        return *item.second;
+                    }
+                }
+            }
+            if (schema_ != nullptr)
+            {
+                std::size_t slot = schema_->find(key);
+                if (slot < params_.size())
+                {
+                    return params_[slot];
+                }
+            }
+            ec = jmespath_errc::undefined_variable;
+            return Json::null();
+        }
+
+        // Value of the parameter a reference to key was resolved to at compile time, looked up
+        // by name if the evaluation was not given parameter values
+        const Json& get_parameter(std::size_t slot, const string_type& key, std::error_code& ec) const
+        {
+            if (slot < params_.size())
             {
-                ec = jmespath_errc::undefined_variable;
-                return Json::null();
+                return params_[slot];
             }
-            return *it->second;
+            return get_variable(key, ec);
         }
 
         reference number_type_name() 
@@ -214,10 +653,7 @@ namespace jmespath {
         template <typename... Args>
         Json* create_json(Args&& ... args)
         {
-            auto temp = jsoncons::make_unique<Json>(std::forward<Args>(args)...);
-            Json* ptr = temp.get();
-            temp_storage_.push_back(std::move(temp));
-            return ptr;
+            return temp_storage_.create(std::forward<Args>(args)...);
         }
     };
 
@@ -301,6 +737,40 @@ namespace jmespath {
             return is_projection_;
         }
 
+        // The field name if this is a plain identifier selector, otherwise nullptr
+        virtual const typename Json::string_type* identifier() const
+        {
+            return nullptr;
+        }
+
+        // Collects the chains of field names read from the value the expression is applied to.
+        // Returns false if the value may be read in any other way.
+        virtual bool input_paths(std::vector<std::vector<typename Json::string_type>>&) const
+        {
+            return false;
+        }
+
+        // True if the expression returns the value it is applied to
+        virtual bool is_identity() const
+        {
+            return false;
+        }
+
+        // True if the result depends on nothing but the value the expression is applied to
+        virtual bool reads_input_only() const
+        {
+            return false;
+        }
+
+        // The result if it is the same whatever the expression is applied to, otherwise nullptr
+        virtual const Json* constant_value() const
+        {
+            return nullptr;
+        }
+
+        // Writes the expression for debugging, one line per part, nested parts indented further
+        virtual void dump(std::basic_ostream<typename Json::char_type>& os, std::size_t indent) const = 0;
+
         virtual void add_expression(expr_base_impl* expressions) = 0;
     };  
 
@@ -551,6 +1021,7 @@ namespace detail {
     public:
         using reference = typename Json::const_reference;
     private:
+        operator_kind kind_;
         std::size_t precedence_level_;
         bool is_right_associative_;
 
@@ -558,11 +1029,17 @@ namespace detail {
         virtual ~unary_operator() = default; 
     public:
         unary_operator(operator_kind oper)
-            : precedence_level_(operator_table::precedence_level(oper)), 
+            : kind_(oper),
+              precedence_level_(operator_table::precedence_level(oper)), 
               is_right_associative_(operator_table::is_right_associative(oper))
         {
         }
 
+        operator_kind kind() const 
+        {
+            return kind_;
+        }
+
         std::size_t precedence_level() const 
         {
             return precedence_level_;
@@ -581,17 +1058,24 @@ namespace detail {
     public:  
         using reference = typename Json::const_reference;
     private:
+        operator_kind kind_;
         std::size_t precedence_level_;
         bool is_right_associative_;
     protected:
         virtual ~binary_operator() = default; 
     public:
         binary_operator(operator_kind oper)
-            : precedence_level_(operator_table::precedence_level(oper)), 
+            : kind_(oper),
+              precedence_level_(operator_table::precedence_level(oper)), 
               is_right_associative_(operator_table::is_right_associative(oper))
         {
         }
 
+        operator_kind kind() const 
+        {
+            return kind_;
+        }
+
 
         std::size_t precedence_level() const 
         {
@@ -823,6 +1307,8 @@ namespace detail {
         token_kind type_;
 
         string_type key_;
+        // Parameter slot of a variable_binding resolved at compile time, no_slot otherwise
+        std::size_t slot_{no_slot};
         union
         {
             expr_base_impl<Json>* expression_;
@@ -832,6 +1318,7 @@ namespace detail {
             Json value_;
         };
     public:
+        static constexpr std::size_t no_slot = (std::numeric_limits<std::size_t>::max)();
 
         token(current_node_arg_t) noexcept
             : type_(token_kind::current_node), expression_{nullptr}
@@ -965,8 +1452,8 @@ namespace detail {
         {
         }
 
-        token(variable_binding_arg_t, const string_type& variable_ref)
-            : type_(token_kind::variable_binding), key_(variable_ref)
+        token(variable_binding_arg_t, const string_type& variable_ref, std::size_t slot = no_slot)
+            : type_(token_kind::variable_binding), key_(variable_ref), slot_(slot)
         {
         }
 
@@ -1097,6 +1584,9 @@ namespace detail {
                     expression_ = other.expression_;
                     break;
                 case token_kind::variable_binding:
+                    key_ = std::move(other.key_);
+                    slot_ = other.slot_;
+                    break;
                 case token_kind::key:
                     key_ = std::move(other.key_);
                     break;
@@ -1130,6 +1620,9 @@ namespace detail {
                     expression_ = other.expression_;
                     break;
                 case token_kind::variable_binding:
+                    key_ = other.key_;
+                    slot_ = other.slot_;
+                    break;
                 case token_kind::key:
                     key_ = other.key_;
                     break;
@@ -1165,6 +1658,9 @@ namespace detail {
             }
         }
     };
+
+    template <typename Json>
+    constexpr std::size_t token<Json>::no_slot;
      
     enum class expr_state 
     {
@@ -1226,27 +1722,129 @@ namespace detail {
         substitute_variable
     };
     
+    // A sort_by, max_by or min_by key, evaluated once per element. Plain
+    // numbers and strings are compared directly, with the same results as
+    // basic_json::compare; any other key falls back to it.
     template <typename Json>
-    struct expression_context
+    class sort_key
     {
-        using string_type = std::basic_string<typename Json::char_type>;
+        using string_view_type = typename Json::string_view_type;
 
-        std::size_t end_index{0};
-        string_type variable_ref;
-        
-        expression_context() = default;
-    };
+        enum class key_kind {int64, uint64, float64, string, other};
 
-    template <typename Json>
-    class jmespath_evaluator 
-    {
+        const Json* value_;
+        key_kind kind_;
+        union
+        {
+            int64_t int64_;
+            uint64_t uint64_;
+            double float64_;
+        };
+        string_view_type sv_;
     public:
-        typedef typename Json::char_type char_type;
-        typedef typename Json::char_traits_type char_traits_type;
-        typedef std::basic_string<char_type,char_traits_type> string_type;
-        typedef typename Json::string_view_type string_view_type;
-        using reference = const Json&;
-        using pointer = typename Json::const_pointer;
+        explicit sort_key(const Json& value)
+            : value_(std::addressof(value)), kind_(key_kind::other), int64_(0)
+        {
+            switch (value.type())
+            {
+                case json_type::int64:
+                    kind_ = key_kind::int64;
+                    int64_ = value.template as<int64_t>();
+                    break;
+                case json_type::uint64:
+                    kind_ = key_kind::uint64;
+                    uint64_ = value.template as<uint64_t>();
+                    break;
+                case json_type::float64:
+                    kind_ = key_kind::float64;
+                    float64_ = value.as_double();
+                    break;
+                case json_type::string:
+                    if (!is_number_tag(value.tag()))
+                    {
+                        kind_ = key_kind::string;
+                        sv_ = value.as_string_view();
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        int compare(const sort_key& other) const noexcept
+        {
+            if (kind_ == key_kind::string && other.kind_ == key_kind::string)
+            {
+                return sv_.compare(other.sv_);
+            }
+            if (kind_ == key_kind::other || other.kind_ == key_kind::other
+                || kind_ == key_kind::string || other.kind_ == key_kind::string)
+            {
+                return value_->compare(*other.value_);
+            }
+            if (kind_ == key_kind::int64 && other.kind_ == key_kind::int64)
+            {
+                return int64_ == other.int64_ ? 0 : (int64_ < other.int64_ ? -1 : 1);
+            }
+            if (kind_ == key_kind::float64 || other.kind_ == key_kind::float64)
+            {
+                double r = to_double() - other.to_double();
+                return r == 0 ? 0 : (r < 0.0 ? -1 : 1);
+            }
+            // int64 and uint64
+            if (kind_ == key_kind::int64 && int64_ < 0)
+            {
+                return -1;
+            }
+            if (other.kind_ == key_kind::int64 && other.int64_ < 0)
+            {
+                return 1;
+            }
+            uint64_t val1 = to_uint64();
+            uint64_t val2 = other.to_uint64();
+            return val1 == val2 ? 0 : (val1 < val2 ? -1 : 1);
+        }
+    private:
+        uint64_t to_uint64() const noexcept
+        {
+            return kind_ == key_kind::int64 ? static_cast<uint64_t>(int64_) : uint64_;
+        }
+
+        double to_double() const noexcept
+        {
+            switch (kind_)
+            {
+                case key_kind::int64:
+                    return static_cast<double>(int64_);
+                case key_kind::uint64:
+                    return static_cast<double>(uint64_);
+                default:
+                    return float64_;
+            }
+        }
+    };
+
+    template <typename Json>
+    struct expression_context
+    {
+        using string_type = std::basic_string<typename Json::char_type>;
+
+        std::size_t end_index{0};
+        string_type variable_ref;
+        
+        expression_context() = default;
+    };
+
+    template <typename Json>
+    class jmespath_evaluator 
+    {
+    public:
+        typedef typename Json::char_type char_type;
+        typedef typename Json::char_traits_type char_traits_type;
+        typedef std::basic_string<char_type,char_traits_type> string_type;
+        typedef typename Json::string_view_type string_view_type;
+        using reference = const Json&;
+        using pointer = typename Json::const_pointer;
         using const_pointer = typename Json::const_pointer;
         using parameter_type = parameter<Json>;
         using expression_type = expr_base_impl<Json>;
@@ -1722,7 +2320,7 @@ namespace detail {
                 const auto& expr = args[1].expression();
 
                 std::error_code ec2;
-                Json key1 = expr.evaluate(arg0.at(0), context, ec2); 
+                reference key1 = expr.evaluate(arg0.at(0), context, ec2); 
 
                 bool is_number = key1.is_number();
                 bool is_string = key1.is_string();
@@ -1732,6 +2330,7 @@ namespace detail {
                     return context.null_value();
                 }
 
+                sort_key<Json> best(key1);
                 std::size_t index = 0;
                 for (std::size_t i = 1; i < arg0.size(); ++i)
                 {
@@ -1741,9 +2340,10 @@ namespace detail {
                         ec = jmespath_errc::invalid_type;
                         return context.null_value();
                     }
-                    if (key2 > key1)
+                    sort_key<Json> key(key2);
+                    if (key.compare(best) > 0)
                     {
-                        key1 = key2;
+                        best = key;
                         index = i;
                     }
                 }
@@ -1882,7 +2482,7 @@ namespace detail {
                 const auto& expr = args[1].expression();
 
                 std::error_code ec2;
-                Json key1 = expr.evaluate(arg0.at(0), context, ec2); 
+                reference key1 = expr.evaluate(arg0.at(0), context, ec2); 
 
                 bool is_number = key1.is_number();
                 bool is_string = key1.is_string();
@@ -1892,6 +2492,7 @@ namespace detail {
                     return context.null_value();
                 }
 
+                sort_key<Json> best(key1);
                 std::size_t index = 0;
                 for (std::size_t i = 1; i < arg0.size(); ++i)
                 {
@@ -1901,9 +2502,10 @@ namespace detail {
                         ec = jmespath_errc::invalid_type;
                         return context.null_value();
                     }
-                    if (key2 < key1)
+                    sort_key<Json> key(key2);
+                    if (key.compare(best) < 0)
                     {
-                        key1 = key2;
+                        best = key;
                         index = i;
                     }
                 }
@@ -2092,28 +2694,51 @@ namespace detail {
 
                 const auto& expr = args[1].expression();
 
-                auto v = context.create_json(arg0);
-                std::stable_sort((v->array_range()).begin(), (v->array_range()).end(),
-                    [&expr,&context,&ec](reference lhs, reference rhs) -> bool
+                // Evaluate each key once, then sort positions rather than values
+                std::vector<sort_key<Json>> keys;
+                keys.reserve(arg0.size());
+                bool is_number = false;
+                bool is_string = false;
+                for (const auto& item : arg0.array_range())
                 {
                     std::error_code ec2;
-                    reference key1 = expr.evaluate(lhs, context, ec2);
-                    bool is_number = key1.is_number();
-                    bool is_string = key1.is_string();
-                    if (!(is_number || is_string))
+                    reference key = expr.evaluate(item, context, ec2);
+                    if (keys.empty())
                     {
-                        ec = jmespath_errc::invalid_type;
+                        is_number = key.is_number();
+                        is_string = key.is_string();
+                        if (!(is_number || is_string))
+                        {
+                            ec = jmespath_errc::invalid_type;
+                            return context.null_value();
+                        }
                     }
-
-                    reference key2 = expr.evaluate(rhs, context, ec2);
-                    if (!(key2.is_number() == is_number && key2.is_string() == is_string))
+                    else if (!(key.is_number() == is_number && key.is_string() == is_string))
                     {
                         ec = jmespath_errc::invalid_type;
+                        return context.null_value();
                     }
-                    
-                    return key1 < key2;
+                    keys.emplace_back(key);
+                }
+
+                std::vector<std::size_t> indices(keys.size());
+                for (std::size_t i = 0; i < indices.size(); ++i)
+                {
+                    indices[i] = i;
+                }
+                std::stable_sort(indices.begin(), indices.end(),
+                    [&keys](std::size_t lhs, std::size_t rhs) -> bool
+                {
+                    return keys[lhs].compare(keys[rhs]) < 0;
                 });
-                return ec ? context.null_value() : *v;
+
+                auto result = context.create_json(json_array_arg);
+                result->reserve(indices.size());
+                for (std::size_t i : indices)
+                {
+                    result->emplace_back(json_const_pointer_arg, std::addressof(arg0.at(i)));
+                }
+                return *result;
             }
         };
 
@@ -2452,15 +3077,181 @@ namespace detail {
             }
         };
 
+        // Collects the chains of field names that evaluating tokens reads from the value they are
+        // evaluated against. Returns false if that value may be read in any other way.
+        static bool token_paths(const std::vector<token<Json>>& tokens, std::vector<std::vector<string_type>>& paths)
+        {
+            bool piped = false;
+            for (std::size_t i = 0; i < tokens.size(); ++i)
+            {
+                switch (tokens[i].type())
+                {
+                    case token_kind::pipe:
+                        // current nodes from here on refer to the piped value
+                        piped = true;
+                        break;
+                    case token_kind::variable:
+                        // the bound expression is evaluated against the same value
+                        if (!tokens[i].expression_->input_paths(paths))
+                        {
+                            return false;
+                        }
+                        break;
+                    case token_kind::current_node:
+                    {
+                        // let bindings sit between a current node and what is applied to it
+                        while (i+1 < tokens.size() && tokens[i+1].type() == token_kind::variable)
+                        {
+                            ++i;
+                            if (!tokens[i].expression_->input_paths(paths))
+                            {
+                                return false;
+                            }
+                        }
+                        // placeholders popped by expression types and variable references do not read the value
+                        if (piped || (i+1 < tokens.size() && 
+                                      (tokens[i+1].type() == token_kind::begin_expression_type ||
+                                       tokens[i+1].type() == token_kind::variable_binding)))
+                        {
+                            break;
+                        }
+                        std::vector<string_type> path;
+                        while (i+1 < tokens.size() && tokens[i+1].is_expression() && 
+                               tokens[i+1].expression_->identifier() != nullptr)
+                        {
+                            path.push_back(*tokens[i+1].expression_->identifier());
+                            ++i;
+                        }
+                        // an expression applied to the end of the chain may only read some of its fields
+                        std::vector<std::vector<string_type>> sub_paths;
+                        if (i+1 < tokens.size() && tokens[i+1].is_expression() && 
+                            tokens[i+1].expression_->input_paths(sub_paths))
+                        {
+                            ++i;
+                            for (auto& sub_path : sub_paths)
+                            {
+                                sub_path.insert(sub_path.begin(), path.begin(), path.end());
+                                paths.push_back(std::move(sub_path));
+                            }
+                            break;
+                        }
+                        if (path.empty())
+                        {
+                            return false;
+                        }
+                        paths.push_back(std::move(path));
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+            return true;
+        }
+
+        static void dump_indent(std::basic_ostream<char_type>& os, std::size_t indent)
+        {
+            for (std::size_t i = 0; i < indent; ++i)
+            {
+                os << "  ";
+            }
+        }
+
+        // Writes a token list for debugging, one line per token, nested expressions indented further
+        static void dump_tokens(const std::vector<token<Json>>& tokens, std::basic_ostream<char_type>& os, std::size_t indent)
+        {
+            for (std::size_t i = 0; i < tokens.size(); ++i)
+            {
+                const auto& t = tokens[i];
+                switch (t.type())
+                {
+                    case token_kind::expression:
+                        t.expression_->dump(os, indent);
+                        continue;
+                    case token_kind::begin_expression_type:
+                        dump_indent(os, indent);
+                        os << "expression_type\n";
+                        if (i+1 < tokens.size() && tokens[i+1].is_expression())
+                        {
+                            ++i;
+                            tokens[i].expression_->dump(os, indent+1);
+                        }
+                        continue;
+                    default:
+                        break;
+                }
+                dump_indent(os, indent);
+                switch (t.type())
+                {
+                    case token_kind::literal:
+                        os << "literal ";
+                        t.value_.dump(os);
+                        os << "\n";
+                        break;
+                    case token_kind::current_node:
+                        os << "current_node\n";
+                        break;
+                    case token_kind::pipe:
+                        os << "pipe\n";
+                        break;
+                    case token_kind::variable:
+                        os << "let $" << t.key_ << "\n";
+                        t.expression_->dump(os, indent+1);
+                        break;
+                    case token_kind::variable_binding:
+                        os << "variable $" << t.key_;
+                        if (t.slot_ != token<Json>::no_slot)
+                        {
+                            os << " slot " << t.slot_;
+                        }
+                        os << "\n";
+                        break;
+                    case token_kind::unary_operator:
+                        os << "unary_operator " << operator_table::symbol(t.unary_operator_->kind()) << "\n";
+                        break;
+                    case token_kind::binary_operator:
+                        os << "binary_operator " << operator_table::symbol(t.binary_operator_->kind()) << "\n";
+                        break;
+                    case token_kind::argument:
+                        os << "argument\n";
+                        break;
+                    case token_kind::function:
+                        os << (t.function_->is_custom() ? "custom_function" : "function");
+                        if (t.function_->arity())
+                        {
+                            os << "/" << *t.function_->arity();
+                        }
+                        os << "\n";
+                        break;
+                    default:
+                        os << "token " << static_cast<int>(t.type()) << "\n";
+                        break;
+                }
+            }
+        }
+
         static pointer evaluate_tokens(reference doc, 
             const std::vector<token<Json>>& output_stack, 
             eval_context<Json>& context, 
             std::error_code& ec)
         {
-            pointer root_ptr = std::addressof(doc);
             std::vector<parameter_type> stack;
+            return evaluate_tokens(doc, output_stack, stack, context, ec);
+        }
+
+        // Evaluates output_stack from the token at first on, with stack holding what the tokens
+        // before it left
+        template <typename OperandStack>
+        static pointer evaluate_tokens(reference doc, 
+            const std::vector<token<Json>>& output_stack, 
+            OperandStack& stack,
+            eval_context<Json>& context, 
+            std::error_code& ec,
+            std::size_t first = 0)
+        {
+            pointer root_ptr = std::addressof(doc);
             std::vector<parameter_type> arg_stack;
-            for (std::size_t i = 0; i < output_stack.size(); ++i)
+            for (std::size_t i = first; i < output_stack.size(); ++i)
             {
                 auto& t = output_stack[i];
                 switch (t.type())
@@ -2508,7 +3299,8 @@ namespace detail {
                     {
                         JSONCONS_ASSERT(!stack.empty());
                         stack.pop_back();
-                        const auto& j = context.get_variable(t.key_, ec);
+                        const auto& j = t.slot_ == token<Json>::no_slot ? context.get_variable(t.key_, ec)
+                                                                        : context.get_parameter(t.slot_, t.key_, ec);
                         if (JSONCONS_UNLIKELY(ec))
                         {
                             ec = jmespath_errc::undefined_variable;
@@ -2586,119 +3378,584 @@ namespace detail {
             return std::addressof(stack.back().value());
         }
 
-        // Implementations
-
-        class or_operator final : public binary_operator<Json>
+        // Operand stack of fixed capacity that lives in the evaluating frame
+        template <std::size_t Capacity>
+        class inline_operand_stack
         {
+            static_assert(std::is_trivially_destructible<parameter_type>::value, "parameter_type must be trivially destructible");
+
+            typename std::aligned_storage<sizeof(parameter_type),alignof(parameter_type)>::type data_[Capacity];
+            std::size_t size_{0};
         public:
-            or_operator()
-                : binary_operator<Json>(operator_kind::or_op)
+            template <typename... Args>
+            void emplace_back(Args&&... args)
             {
+                JSONCONS_ASSERT(size_ < Capacity);
+                ::new(static_cast<void*>(data_ + size_)) parameter_type(std::forward<Args>(args)...);
+                ++size_;
             }
 
-            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override
+            void push_back(const parameter_type& param)
             {
-                if (lhs.is_null() && rhs.is_null())
-                {
-                    return context.null_value();
-                }
-                if (!is_false(lhs))
-                {
-                    return lhs;
-                }
-                else
-                {
-                    return rhs;
-                }
+                emplace_back(param);
             }
-        };
 
-        class and_operator final : public binary_operator<Json>
-        {
-        public:
-            and_operator()
-                : binary_operator<Json>(operator_kind::and_op)
+            void pop_back()
             {
+                --size_;
             }
 
-            reference evaluate(reference lhs, reference rhs, eval_context<Json>&, std::error_code&) const override
+            parameter_type& back()
             {
-                if (is_true(lhs))
-                {
-                    return rhs;
-                }
-                else
-                {
-                    return lhs;
-                }
+                return *reinterpret_cast<parameter_type*>(data_ + (size_ - 1));
             }
-        };
 
-        class eq_operator final : public binary_operator<Json>
-        {
-        public:
-            eq_operator()
-                : binary_operator<Json>(operator_kind::eq_op)
+            bool empty() const
             {
+                return size_ == 0;
             }
 
-            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override 
+            std::size_t size() const
             {
-                return lhs == rhs ? context.true_value() : context.false_value();
+                return size_;
             }
         };
 
-        class ne_operator final : public binary_operator<Json>
+        // A token list lowered once at compile time. The list is checked and its operand stack
+        // depth computed up front, so that a chain of expressions applied to the current node
+        // runs as a plain loop and other lists run on an inline operand stack. Lists that are
+        // too deep for it are run by evaluate_tokens.
+        class token_program
         {
+            static constexpr std::size_t max_inline_depth = 16;
+
+            enum class program_kind {interpreted, chain, inline_stack};
+
+            std::vector<token<Json>> tokens_;
+            program_kind kind_{program_kind::interpreted};
         public:
-            ne_operator()
-                : binary_operator<Json>(operator_kind::ne_op)
+            token_program() = default;
+
+            explicit token_program(std::vector<token<Json>>&& tokens)
+                : tokens_(optimize(std::move(tokens))), 
+                  kind_(JSONCONS_JMESPATH_LOWER_PROGRAMS ? lower(tokens_) : program_kind::interpreted)
             {
             }
 
-            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override 
+            const std::vector<token<Json>>& tokens() const
             {
-                return lhs != rhs ? context.true_value() : context.false_value();
+                return tokens_;
             }
-        };
 
-        class lt_operator final : public binary_operator<Json>
-        {
-        public:
-            lt_operator()
-                : binary_operator<Json>(operator_kind::lt_op)
+            bool empty() const
             {
+                return tokens_.empty();
             }
 
-            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override 
+            // The value of a list that was folded into a single literal, otherwise nullptr
+            const Json* constant_value() const
             {
-                if (!(lhs.is_number() && rhs.is_number()))
-                {
-                    return context.null_value();
-                }
-                return lhs < rhs ? context.true_value() : context.false_value();
+                return tokens_.size() == 1 && tokens_[0].type() == token_kind::literal ? std::addressof(tokens_[0].value_) : nullptr;
             }
-        };
 
-        class lte_operator final : public binary_operator<Json>
-        {
-        public:
-            lte_operator()
-                : binary_operator<Json>(operator_kind::lte_op)
+            pointer evaluate(reference doc, eval_context<Json>& context, std::error_code& ec) const
             {
+                switch (kind_)
+                {
+                    case program_kind::chain:
+                    {
+                        pointer ptr = std::addressof(doc);
+                        for (std::size_t i = 1; i < tokens_.size(); ++i)
+                        {
+                            ptr = std::addressof(tokens_[i].expression_->evaluate(*ptr, context, ec));
+                        }
+                        return ptr;
+                    }
+                    case program_kind::inline_stack:
+                    {
+                        inline_operand_stack<max_inline_depth> stack;
+                        return evaluate_tokens(doc, tokens_, stack, context, ec);
+                    }
+                    default:
+                        return evaluate_tokens(doc, tokens_, context, ec);
+                }
             }
 
-            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override 
+            // Number of field names in the chain the list starts with, e.g. 2 for "a.b[0] == c"
+            std::size_t leading_path_length() const
             {
-                if (!(lhs.is_number() && rhs.is_number()))
+                if (tokens_.empty() || !tokens_[0].is_current_node())
                 {
-                    return context.null_value();
+                    return 0;
                 }
-                return lhs <= rhs ? context.true_value() : context.false_value();
+                std::size_t length = 0;
+                while (length+1 < tokens_.size() && tokens_[length+1].is_expression() &&
+                       tokens_[length+1].expression_->identifier() != nullptr)
+                {
+                    ++length;
+                }
+                return length;
             }
-        };
 
-        class gt_operator final : public binary_operator<Json>
+            // Evaluates as if the first path_length field names of the leading chain had been
+            // looked up in doc already, giving value
+            pointer evaluate_from(reference doc, std::size_t path_length, reference value, 
+                eval_context<Json>& context, std::error_code& ec) const
+            {
+                if (path_length == 0)
+                {
+                    return evaluate(doc, context, ec);
+                }
+                JSONCONS_ASSERT(path_length <= leading_path_length());
+                const std::size_t first = path_length + 1;
+                switch (kind_)
+                {
+                    case program_kind::chain:
+                    {
+                        pointer ptr = std::addressof(value);
+                        for (std::size_t i = first; i < tokens_.size(); ++i)
+                        {
+                            ptr = std::addressof(tokens_[i].expression_->evaluate(*ptr, context, ec));
+                        }
+                        return ptr;
+                    }
+                    case program_kind::inline_stack:
+                    {
+                        inline_operand_stack<max_inline_depth> stack;
+                        stack.emplace_back(value);
+                        return evaluate_tokens(doc, tokens_, stack, context, ec, first);
+                    }
+                    default:
+                    {
+                        std::vector<parameter_type> stack;
+                        stack.emplace_back(value);
+                        return evaluate_tokens(doc, tokens_, stack, context, ec, first);
+                    }
+                }
+            }
+        private:
+            // An operand on the stack while optimizing, made of the tokens from start to the end
+            // of the output. A constant operand is a single literal.
+            struct operand
+            {
+                std::size_t start;
+                bool constant;
+            };
+
+            // Rewrites a token list into an equivalent one that does less work per evaluation:
+            // operators and built in functions applied to literals, and expressions that read
+            // nothing but a literal, are evaluated once and replaced by the resulting literal.
+            // && and || with a literal left operand keep only the side that decides the result
+            // when the other cannot fail, and identity expressions and pipes that no later current node reads are dropped.
+            // Operations that fail are kept, so that they still fail when evaluated.
+            static std::vector<token<Json>> optimize(std::vector<token<Json>>&& tokens)
+            {
+                std::size_t last_current_node = tokens.size();
+                for (std::size_t i = 0; i < tokens.size(); ++i)
+                {
+                    if (tokens[i].is_current_node())
+                    {
+                        last_current_node = i;
+                    }
+                }
+
+                std::vector<token<Json>> output;
+                output.reserve(tokens.size());
+                std::vector<operand> operands;
+                std::vector<operand> arguments;
+                for (std::size_t i = 0; i < tokens.size(); ++i)
+                {
+                    const auto& t = tokens[i];
+                    switch (t.type())
+                    {
+                        case token_kind::literal:
+                            output.push_back(t);
+                            operands.push_back(operand{output.size()-1, true});
+                            break;
+                        case token_kind::current_node:
+                            output.push_back(t);
+                            operands.push_back(operand{output.size()-1, false});
+                            break;
+                        case token_kind::pipe:
+                            if (operands.empty())
+                            {
+                                return std::move(tokens);
+                            }
+                            // only current nodes read the piped value
+                            if (last_current_node < tokens.size() && i < last_current_node)
+                            {
+                                output.push_back(t);
+                                operands.back().constant = false;
+                            }
+                            break;
+                        case token_kind::begin_expression_type:
+                            if (operands.empty() || i+1 == tokens.size())
+                            {
+                                return std::move(tokens);
+                            }
+                            output.push_back(t);
+                            output.push_back(tokens[++i]);
+                            operands.back().constant = false;
+                            break;
+                        case token_kind::expression:
+                        {
+                            if (operands.empty())
+                            {
+                                return std::move(tokens);
+                            }
+                            if (t.expression_->is_identity())
+                            {
+                                break;
+                            }
+                            operand& arg = operands.back();
+                            const Json* value = t.expression_->constant_value();
+                            if (value != nullptr && arg.start+1 == output.size() && 
+                                (output.back().type() == token_kind::literal || output.back().is_current_node()))
+                            {
+                                output.back() = token<Json>(literal_arg_t{}, deep_copy(*value));
+                                arg.constant = true;
+                                break;
+                            }
+                            output.push_back(t);
+                            arg.constant = arg.constant && t.expression_->reads_input_only();
+                            fold(output, arg);
+                            break;
+                        }
+                        case token_kind::variable_binding:
+                            if (operands.empty())
+                            {
+                                return std::move(tokens);
+                            }
+                            output.push_back(t);
+                            operands.back().constant = false;
+                            break;
+                        case token_kind::unary_operator:
+                            if (operands.empty())
+                            {
+                                return std::move(tokens);
+                            }
+                            output.push_back(t);
+                            fold(output, operands.back());
+                            break;
+                        case token_kind::binary_operator:
+                        {
+                            if (operands.size() < 2)
+                            {
+                                return std::move(tokens);
+                            }
+                            operand rhs = operands.back();
+                            operands.pop_back();
+                            operand& lhs = operands.back();
+                            operator_kind kind = t.binary_operator_->kind();
+                            if (lhs.constant && !rhs.constant && (kind == operator_kind::or_op || kind == operator_kind::and_op))
+                            {
+                                bool lhs_true = is_true(output[lhs.start].value_);
+                                if (lhs_true == (kind == operator_kind::or_op))
+                                {
+                                    // the result is the left operand, the right one is still evaluated
+                                    // at run time, so it may only be left out if it cannot fail
+                                    if (infallible(output, rhs.start))
+                                    {
+                                        output.erase(output.begin()+rhs.start, output.end());
+                                        break;
+                                    }
+                                }
+                                else
+                                {
+                                    // the result is the right operand
+                                    output.erase(output.begin()+lhs.start);
+                                    lhs.constant = false;
+                                    break;
+                                }
+                            }
+                            output.push_back(t);
+                            lhs.constant = lhs.constant && rhs.constant;
+                            fold(output, lhs);
+                            break;
+                        }
+                        case token_kind::argument:
+                            if (operands.empty())
+                            {
+                                return std::move(tokens);
+                            }
+                            output.push_back(t);
+                            arguments.push_back(operands.back());
+                            operands.pop_back();
+                            break;
+                        case token_kind::function:
+                        {
+                            operand result{arguments.empty() ? output.size() : arguments.front().start, !t.function_->is_custom()};
+                            for (const auto& arg : arguments)
+                            {
+                                result.constant = result.constant && arg.constant;
+                            }
+                            // an operand left between the arguments is not part of the call
+                            if (!operands.empty() && operands.back().start >= result.start)
+                            {
+                                result.constant = false;
+                            }
+                            arguments.clear();
+                            output.push_back(t);
+                            operands.push_back(result);
+                            fold(output, operands.back());
+                            break;
+                        }
+                        default:
+                            output.push_back(t);
+                            break;
+                    }
+                }
+                return output;
+            }
+
+            // True if the tokens from start on only compute a value, so they may be left out
+            static bool droppable(const std::vector<token<Json>>& output, std::size_t start)
+            {
+                for (std::size_t i = start; i < output.size(); ++i)
+                {
+                    switch (output[i].type())
+                    {
+                        case token_kind::pipe:
+                        case token_kind::variable:
+                        case token_kind::variable_binding:
+                            return false;
+                        default:
+                            break;
+                    }
+                }
+                return true;
+            }
+
+            // True if the tokens from start on cannot fail, so that leaving them out does not hide
+            // an error: literals and chains of field names looked up from the current node
+            static bool infallible(const std::vector<token<Json>>& output, std::size_t start)
+            {
+                for (std::size_t i = start; i < output.size(); ++i)
+                {
+                    switch (output[i].type())
+                    {
+                        case token_kind::current_node:
+                        case token_kind::literal:
+                            break;
+                        case token_kind::expression:
+                            if (output[i].expression_->identifier() == nullptr)
+                            {
+                                return false;
+                            }
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+                return true;
+            }
+
+            // Replaces the tokens of a constant operand by a literal of their value
+            static void fold(std::vector<token<Json>>& output, operand& arg)
+            {
+                if (!arg.constant || (arg.start+1 == output.size() && output.back().type() == token_kind::literal))
+                {
+                    return;
+                }
+                if (!droppable(output, arg.start))
+                {
+                    arg.constant = false;
+                    return;
+                }
+                std::vector<token<Json>> segment(output.begin()+arg.start, output.end());
+                temp_json_storage<Json> storage;
+                eval_context<Json> context{storage};
+                std::error_code ec;
+                Json value = deep_copy(*evaluate_tokens(Json::null(), segment, context, ec));
+                if (ec)
+                {
+                    arg.constant = false;
+                    return;
+                }
+                output.erase(output.begin()+arg.start, output.end());
+                output.emplace_back(literal_arg_t{}, std::move(value));
+            }
+
+            static program_kind lower(const std::vector<token<Json>>& tokens)
+            {
+                if (tokens.empty())
+                {
+                    return program_kind::interpreted;
+                }
+                bool chain = tokens[0].type() == token_kind::current_node;
+                std::size_t depth = 0;
+                std::size_t max_depth = 0;
+                for (std::size_t i = 0; i < tokens.size(); ++i)
+                {
+                    std::size_t pops = 0;
+                    std::size_t pushes = 0;
+                    switch (tokens[i].type())
+                    {
+                        case token_kind::literal:
+                        case token_kind::current_node:
+                            pushes = 1;
+                            break;
+                        case token_kind::begin_expression_type:
+                            if (i+1 == tokens.size() || !tokens[i+1].is_expression())
+                            {
+                                return program_kind::interpreted;
+                            }
+                            ++i;
+                            pops = pushes = 1;
+                            break;
+                        case token_kind::pipe:
+                            pops = pushes = 1;
+                            break;
+                        case token_kind::expression:
+                        case token_kind::variable_binding:
+                        case token_kind::unary_operator:
+                            pops = pushes = 1;
+                            break;
+                        case token_kind::binary_operator:
+                            pops = 2;
+                            pushes = 1;
+                            break;
+                        case token_kind::argument:
+                            pops = 1;
+                            break;
+                        case token_kind::function:
+                            pushes = 1;
+                            break;
+                        default:
+                            break;
+                    }
+                    if (depth < pops)
+                    {
+                        return program_kind::interpreted;
+                    }
+                    depth = depth - pops + pushes;
+                    max_depth = (std::max)(max_depth, depth);
+                    if (i > 0 && tokens[i].type() != token_kind::expression)
+                    {
+                        chain = false;
+                    }
+                }
+                if (depth != 1 || max_depth > max_inline_depth)
+                {
+                    return program_kind::interpreted;
+                }
+                return chain ? program_kind::chain : program_kind::inline_stack;
+            }
+        };
+
+        // Implementations
+
+        class or_operator final : public binary_operator<Json>
+        {
+        public:
+            or_operator()
+                : binary_operator<Json>(operator_kind::or_op)
+            {
+            }
+
+            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override
+            {
+                if (lhs.is_null() && rhs.is_null())
+                {
+                    return context.null_value();
+                }
+                if (!is_false(lhs))
+                {
+                    return lhs;
+                }
+                else
+                {
+                    return rhs;
+                }
+            }
+        };
+
+        class and_operator final : public binary_operator<Json>
+        {
+        public:
+            and_operator()
+                : binary_operator<Json>(operator_kind::and_op)
+            {
+            }
+
+            reference evaluate(reference lhs, reference rhs, eval_context<Json>&, std::error_code&) const override
+            {
+                if (is_true(lhs))
+                {
+                    return rhs;
+                }
+                else
+                {
+                    return lhs;
+                }
+            }
+        };
+
+        class eq_operator final : public binary_operator<Json>
+        {
+        public:
+            eq_operator()
+                : binary_operator<Json>(operator_kind::eq_op)
+            {
+            }
+
+            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override 
+            {
+                return lhs == rhs ? context.true_value() : context.false_value();
+            }
+        };
+
+        class ne_operator final : public binary_operator<Json>
+        {
+        public:
+            ne_operator()
+                : binary_operator<Json>(operator_kind::ne_op)
+            {
+            }
+
+            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override 
+            {
+                return lhs != rhs ? context.true_value() : context.false_value();
+            }
+        };
+
+        class lt_operator final : public binary_operator<Json>
+        {
+        public:
+            lt_operator()
+                : binary_operator<Json>(operator_kind::lt_op)
+            {
+            }
+
+            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override 
+            {
+                if (!(lhs.is_number() && rhs.is_number()))
+                {
+                    return context.null_value();
+                }
+                return lhs < rhs ? context.true_value() : context.false_value();
+            }
+        };
+
+        class lte_operator final : public binary_operator<Json>
+        {
+        public:
+            lte_operator()
+                : binary_operator<Json>(operator_kind::lte_op)
+            {
+            }
+
+            reference evaluate(reference lhs, reference rhs, eval_context<Json>& context, std::error_code&) const override 
+            {
+                if (!(lhs.is_number() && rhs.is_number()))
+                {
+                    return context.null_value();
+                }
+                return lhs <= rhs ? context.true_value() : context.false_value();
+            }
+        };
+
+        class gt_operator final : public binary_operator<Json>
         {
         public:
             gt_operator()
@@ -2758,17 +4015,27 @@ namespace detail {
             {
             }
 
+            const string_type* identifier() const override
+            {
+                return std::addressof(identifier_);
+            }
+
             reference evaluate(reference val, eval_context<Json>& context, std::error_code&) const override
             {
                 //std::cout << "(identifier_selector " << identifier_  << " ) " << pretty_print(val) << "\n";
-                if (val.is_object() && val.contains(identifier_))
-                {
-                    return val.at(identifier_);
-                }
-                else 
-                {
-                    return context.null_value();
-                }
+                const Json* member = val.find_value(identifier_);
+                return member != nullptr ? *member : context.null_value();
+            }
+
+            bool reads_input_only() const override
+            {
+                return true;
+            }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "identifier " << identifier_ << "\n";
             }
         };
 
@@ -2783,6 +4050,22 @@ namespace detail {
             {
                 return val;
             }
+
+            bool is_identity() const override
+            {
+                return true;
+            }
+
+            bool reads_input_only() const override
+            {
+                return true;
+            }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "current_node_expression\n";
+            }
         };
 
         class index_selector final : public basic_expression
@@ -2816,6 +4099,17 @@ namespace detail {
                     return context.null_value();
                 }
             }
+
+            bool reads_input_only() const override
+            {
+                return true;
+            }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "index " << index_ << "\n";
+            }
         };
 
         // projection_base
@@ -2843,6 +4137,14 @@ namespace detail {
                 }
             }
 
+            void dump_expressions(std::basic_ostream<char_type>& os, std::size_t indent) const
+            {
+                for (auto& expression : expressions_)
+                {
+                    expression->dump(os, indent);
+                }
+            }
+
             reference apply_expressions(reference val, eval_context<Json>& context, std::error_code& ec) const
             {
                 pointer ptr = std::addressof(val);
@@ -2852,6 +4154,95 @@ namespace detail {
                 }
                 return *ptr;
             }
+
+            // Whether a projection over count elements is split into chunks on the pool of the evaluation
+            static bool is_parallel(const eval_context<Json>& context, std::size_t count)
+            {
+                return context.pool() != nullptr && count >= context.pool()->threshold();
+            }
+
+            // Applies the expressions to the elements and appends the results that are not null
+            // to result in order, in chunks on the pool of the evaluation if there are enough
+            // of them. Each chunk creates its temporaries in a storage of its own, which the
+            // storage of the evaluation takes over.
+            void apply_expressions(const std::vector<pointer>& elements, Json& result, 
+                eval_context<Json>& context, std::error_code& ec) const
+            {
+                if (!is_parallel(context, elements.size()))
+                {
+                    for (pointer element : elements)
+                    {
+                        reference j = apply_expressions(*element, context, ec);
+                        if (!j.is_null())
+                        {
+                            result.emplace_back(json_const_pointer_arg, std::addressof(j));
+                        }
+                    }
+                    return;
+                }
+
+                struct chunk
+                {
+                    std::unique_ptr<temp_json_storage<Json>> storage;
+                    std::vector<pointer> values;
+                    std::error_code ec;
+                    std::exception_ptr exception;
+                };
+
+                projection_pool& pool = *context.pool();
+                // a few chunks per thread, so that uneven chunks even out
+                const std::size_t chunk_count = (std::min)(elements.size(), pool.concurrency()*4);
+                std::vector<chunk> chunks(chunk_count);
+                pool.run(chunk_count, [&](std::size_t k) {
+                    chunk& c = chunks[k];
+                    const std::size_t first = elements.size()*k/chunk_count;
+                    const std::size_t last = elements.size()*(k+1)/chunk_count;
+                    JSONCONS_TRY
+                    {
+                        c.storage.reset(new temp_json_storage<Json>());
+                        // projections within the chunk are serial
+                        eval_context<Json> chunk_context{*c.storage, context, nullptr};
+                        c.values.reserve(last - first);
+                        for (std::size_t i = first; i < last; ++i)
+                        {
+                            reference j = apply_expressions(*elements[i], chunk_context, c.ec);
+                            if (!j.is_null())
+                            {
+                                c.values.push_back(std::addressof(j));
+                            }
+                        }
+                    }
+                    JSONCONS_CATCH(...)
+                    {
+                        c.exception = std::current_exception();
+                    }
+                });
+
+                std::exception_ptr exception;
+                for (auto& c : chunks)
+                {
+                    for (pointer value : c.values)
+                    {
+                        result.emplace_back(json_const_pointer_arg, value);
+                    }
+                    if (c.ec && !ec)
+                    {
+                        ec = c.ec;
+                    }
+                    if (c.exception && !exception)
+                    {
+                        exception = c.exception;
+                    }
+                    if (c.storage)
+                    {
+                        context.temp_storage_.adopt(std::move(c.storage));
+                    }
+                }
+                if (exception)
+                {
+                    std::rethrow_exception(exception);
+                }
+            }
         };
 
         class object_projection final : public projection_base
@@ -2870,6 +4261,20 @@ namespace detail {
                 }
 
                 auto result = context.create_json(json_array_arg);
+                if (this->is_parallel(context, val.size()))
+                {
+                    std::vector<pointer> elements;
+                    elements.reserve(val.size());
+                    for (auto& item : val.object_range())
+                    {
+                        if (!item.value().is_null())
+                        {
+                            elements.push_back(std::addressof(item.value()));
+                        }
+                    }
+                    this->apply_expressions(elements, *result, context, ec);
+                    return *result;
+                }
                 for (auto& item : val.object_range())
                 {
                     if (!item.value().is_null())
@@ -2883,6 +4288,13 @@ namespace detail {
                 }
                 return *result;
             }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "object_projection\n";
+                this->dump_expressions(os, indent+1);
+            }
         };
 
         class list_projection final : public projection_base
@@ -2901,6 +4313,20 @@ namespace detail {
                 }
 
                 auto result = context.create_json(json_array_arg);
+                if (this->is_parallel(context, val.size()))
+                {
+                    std::vector<pointer> elements;
+                    elements.reserve(val.size());
+                    for (reference item : val.array_range())
+                    {
+                        if (!item.is_null())
+                        {
+                            elements.push_back(std::addressof(item));
+                        }
+                    }
+                    this->apply_expressions(elements, *result, context, ec);
+                    return *result;
+                }
                 for (reference item : val.array_range())
                 {
                     if (!item.is_null())
@@ -2914,6 +4340,13 @@ namespace detail {
                 }
                 return *result;
             }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "list_projection\n";
+                this->dump_expressions(os, indent+1);
+            }
         };
 
         class slice_projection final : public projection_base
@@ -2943,6 +4376,8 @@ namespace detail {
                 }
 
                 auto result = context.create_json(json_array_arg);
+                const bool parallel = this->is_parallel(context, val.size());
+                std::vector<pointer> elements;
                 if (step > 0)
                 {
                     if (start < 0)
@@ -2955,6 +4390,11 @@ namespace detail {
                     }
                     for (int64_t i = start; i < end; i += step)
                     {
+                        if (parallel)
+                        {
+                            elements.push_back(std::addressof(val.at(static_cast<std::size_t>(i))));
+                            continue;
+                        }
                         reference j = this->apply_expressions(val.at(static_cast<std::size_t>(i)), context, ec);
                         if (!j.is_null())
                         {
@@ -2966,32 +4406,348 @@ namespace detail {
                 {
                     if (start >= static_cast<int64_t>(val.size()))
                     {
-                        start = static_cast<int64_t>(val.size()) - 1;
+                        start = static_cast<int64_t>(val.size()) - 1;
+                    }
+                    if (end < -1)
+                    {
+                        end = -1;
+                    }
+                    for (int64_t i = start; i > end; i += step)
+                    {
+                        if (parallel)
+                        {
+                            elements.push_back(std::addressof(val.at(static_cast<std::size_t>(i))));
+                            continue;
+                        }
+                        reference j = this->apply_expressions(val.at(static_cast<std::size_t>(i)), context, ec);
+                        if (!j.is_null())
+                        {
+                            result->emplace_back(json_const_pointer_arg, std::addressof(j));
+                        }
+                    }
+                }
+                if (parallel)
+                {
+                    this->apply_expressions(elements, *result, context, ec);
+                }
+
+                return *result;
+            }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "slice_projection\n";
+                this->dump_expressions(os, indent+1);
+            }
+        };
+
+        // A filter condition made only of comparisons between a chain of field names and a number
+        // literal, combined with && and ||, e.g. "price > `100` && qty < `5`". It is evaluated
+        // for a block of array elements at a time: the field of every element is gathered into a
+        // buffer of doubles, then each comparison and each && or || runs as a loop without
+        // branches over the whole block, which the compiler can vectorize. Elements whose field
+        // cannot be compared as a double with the same result as Json::compare (big integers,
+        // numbers held as strings, half floats) are marked to be evaluated by the token program.
+        class numeric_condition
+        {
+        public:
+            static constexpr std::size_t block_size = 256;
+
+            // Values of evaluate's selection
+            static constexpr uint8_t rejected = 0;
+            static constexpr uint8_t selected = 1;
+            static constexpr uint8_t undecided = 2;
+        private:
+            // Integers beyond this magnitude may not convert to double exactly
+            static constexpr int64_t max_exact_integer = int64_t(1) << 53;
+
+            struct comparison
+            {
+                std::vector<string_type> path;
+                operator_kind kind;
+                double literal;
+                bool literal_is_integer;
+                bool literal_first;
+            };
+
+            // A step of the condition in postfix order: a comparison or && or ||
+            struct step
+            {
+                operator_kind kind;
+                std::size_t index;
+            };
+
+            std::vector<comparison> comparisons_;
+            std::vector<step> steps_;
+            std::size_t max_depth_{0};
+        public:
+            numeric_condition() = default;
+
+            // Recognizes the condition in tokens, leaving it empty if they are of any other form
+            explicit numeric_condition(const std::vector<token<Json>>& tokens)
+            {
+                if (!parse(tokens))
+                {
+                    comparisons_.clear();
+                    steps_.clear();
+                    max_depth_ = 0;
+                }
+            }
+
+            bool empty() const
+            {
+                return steps_.empty();
+            }
+
+            // Sets selection[i] to selected or rejected for each of the n elements, or to
+            // undecided if the condition has to be evaluated for it by other means. masks must
+            // hold at least max_depth()*block_size values.
+            void evaluate(const Json* const* elements, std::size_t n, uint8_t* selection, uint8_t* masks) const
+            {
+                JSONCONS_ASSERT(n <= block_size);
+                double keys[block_size];
+                uint8_t numbers[block_size];
+                uint8_t undecided_elements[block_size] = {0};
+
+                std::size_t depth = 0;
+                for (const auto& s : steps_)
+                {
+                    if (s.kind == operator_kind::and_op || s.kind == operator_kind::or_op)
+                    {
+                        --depth;
+                        uint8_t* lhs = masks + (depth-1)*block_size;
+                        const uint8_t* rhs = masks + depth*block_size;
+                        if (s.kind == operator_kind::and_op)
+                        {
+                            for (std::size_t i = 0; i < n; ++i)
+                            {
+                                lhs[i] &= rhs[i];
+                            }
+                        }
+                        else
+                        {
+                            for (std::size_t i = 0; i < n; ++i)
+                            {
+                                lhs[i] |= rhs[i];
+                            }
+                        }
+                        continue;
+                    }
+                    const comparison& c = comparisons_[s.index];
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        uint8_t state = gather(*elements[i], c, keys[i]);
+                        numbers[i] = state == selected;
+                        undecided_elements[i] |= state & undecided;
+                    }
+                    // the sign of the difference, as in Json::compare, a NaN difference compares greater
+                    if (c.literal_first)
+                    {
+                        for (std::size_t i = 0; i < n; ++i)
+                        {
+                            keys[i] = c.literal - keys[i];
+                        }
+                    }
+                    else
+                    {
+                        for (std::size_t i = 0; i < n; ++i)
+                        {
+                            keys[i] = keys[i] - c.literal;
+                        }
+                    }
+                    uint8_t* mask = masks + depth*block_size;
+                    ++depth;
+                    switch (c.kind)
+                    {
+                        case operator_kind::eq_op:
+                            for (std::size_t i = 0; i < n; ++i)
+                            {
+                                mask[i] = numbers[i] & static_cast<uint8_t>(keys[i] == 0.0);
+                            }
+                            break;
+                        case operator_kind::ne_op:
+                            for (std::size_t i = 0; i < n; ++i)
+                            {
+                                mask[i] = 1 ^ (numbers[i] & static_cast<uint8_t>(keys[i] == 0.0));
+                            }
+                            break;
+                        case operator_kind::lt_op:
+                            for (std::size_t i = 0; i < n; ++i)
+                            {
+                                mask[i] = numbers[i] & static_cast<uint8_t>(keys[i] < 0.0);
+                            }
+                            break;
+                        case operator_kind::lte_op:
+                            for (std::size_t i = 0; i < n; ++i)
+                            {
+                                mask[i] = numbers[i] & static_cast<uint8_t>(keys[i] <= 0.0);
+                            }
+                            break;
+                        case operator_kind::gt_op:
+                            for (std::size_t i = 0; i < n; ++i)
+                            {
+                                mask[i] = numbers[i] & static_cast<uint8_t>(!(keys[i] <= 0.0));
+                            }
+                            break;
+                        default: // gte_op
+                            for (std::size_t i = 0; i < n; ++i)
+                            {
+                                mask[i] = numbers[i] & static_cast<uint8_t>(!(keys[i] < 0.0));
+                            }
+                            break;
+                    }
+                }
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    selection[i] = undecided_elements[i] ? undecided : masks[i];
+                }
+            }
+
+            // Number of comparison results held at once by evaluate
+            std::size_t max_depth() const
+            {
+                return max_depth_;
+            }
+        private:
+            bool parse(const std::vector<token<Json>>& tokens)
+            {
+                // operands: a field chain being built, a number literal or a condition
+                enum class operand_kind {path, literal, condition};
+                struct operand
+                {
+                    operand_kind kind;
+                    std::vector<string_type> path;
+                    const Json* literal;
+                };
+                std::vector<operand> stack;
+                std::size_t depth = 0;
+                for (const auto& t : tokens)
+                {
+                    switch (t.type())
+                    {
+                        case token_kind::current_node:
+                            stack.push_back(operand{operand_kind::path, {}, nullptr});
+                            break;
+                        case token_kind::expression:
+                            if (stack.empty() || stack.back().kind != operand_kind::path || t.expression_->identifier() == nullptr)
+                            {
+                                return false;
+                            }
+                            stack.back().path.push_back(*t.expression_->identifier());
+                            break;
+                        case token_kind::literal:
+                            if (!is_exact_number(t.value_))
+                            {
+                                return false;
+                            }
+                            stack.push_back(operand{operand_kind::literal, {}, std::addressof(t.value_)});
+                            break;
+                        case token_kind::binary_operator:
+                        {
+                            if (stack.size() < 2)
+                            {
+                                return false;
+                            }
+                            operand rhs = std::move(stack.back());
+                            stack.pop_back();
+                            operand lhs = std::move(stack.back());
+                            stack.pop_back();
+                            operator_kind kind = t.binary_operator_->kind();
+                            if (kind == operator_kind::and_op || kind == operator_kind::or_op)
+                            {
+                                if (lhs.kind != operand_kind::condition || rhs.kind != operand_kind::condition)
+                                {
+                                    return false;
+                                }
+                                steps_.push_back(step{kind, 0});
+                                --depth;
+                            }
+                            else
+                            {
+                                bool literal_first = lhs.kind == operand_kind::literal;
+                                operand& path = literal_first ? rhs : lhs;
+                                operand& literal = literal_first ? lhs : rhs;
+                                if (path.kind != operand_kind::path || literal.kind != operand_kind::literal)
+                                {
+                                    return false;
+                                }
+                                steps_.push_back(step{kind, comparisons_.size()});
+                                comparisons_.push_back(comparison{std::move(path.path), kind, literal.literal->as_double(), 
+                                                                  literal.literal->type() != json_type::float64, literal_first});
+                                max_depth_ = (std::max)(max_depth_, ++depth);
+                            }
+                            stack.push_back(operand{operand_kind::condition, {}, nullptr});
+                            break;
+                        }
+                        default:
+                            return false;
+                    }
+                }
+                return stack.size() == 1 && stack.back().kind == operand_kind::condition;
+            }
+
+            static bool is_exact_number(const Json& val)
+            {
+                switch (val.type())
+                {
+                    case json_type::float64:
+                        return true;
+                    case json_type::int64:
+                    {
+                        int64_t n = val.template as<int64_t>();
+                        return n <= max_exact_integer && n >= -max_exact_integer;
                     }
-                    if (end < -1)
+                    case json_type::uint64:
+                        return val.template as<uint64_t>() <= static_cast<uint64_t>(max_exact_integer);
+                    default:
+                        return false;
+                }
+            }
+
+            // Looks up the field of the comparison in an element. Returns selected with key set if
+            // it is a number that compares with the literal as a double would, rejected if it is
+            // not a number, or undecided.
+            static uint8_t gather(const Json& element, const comparison& c, double& key)
+            {
+                key = 0;
+                const Json* val = std::addressof(element);
+                for (const auto& name : c.path)
+                {
+                    val = val->find_value(name);
+                    if (val == nullptr)
                     {
-                        end = -1;
+                        return rejected;
                     }
-                    for (int64_t i = start; i > end; i += step)
-                    {
-                        reference j = this->apply_expressions(val.at(static_cast<std::size_t>(i)), context, ec);
-                        if (!j.is_null())
+                }
+                switch (val->type())
+                {
+                    case json_type::float64:
+                        key = val->as_double();
+                        return selected;
+                    case json_type::int64:
+                    case json_type::uint64:
+                        // against a float literal Json::compare converts the integer to double,
+                        // against an integer one it compares exactly
+                        if (c.literal_is_integer && !is_exact_number(*val))
                         {
-                            result->emplace_back(json_const_pointer_arg, std::addressof(j));
+                            return undecided;
                         }
-                    }
+                        key = val->as_double();
+                        return selected;
+                    default:
+                        return val->is_number() ? undecided : rejected;
                 }
-
-                return *result;
             }
         };
 
         class filter_expression final : public projection_base
         {
-            std::vector<token<Json>> token_list_;
+            token_program program_;
+            numeric_condition condition_;
         public:
             filter_expression(std::vector<token<Json>>&& token_list)
-                : projection_base(operator_kind::projection_op), token_list_(std::move(token_list))
+                : projection_base(operator_kind::projection_op), program_(std::move(token_list)), condition_(program_.tokens())
             {
             }
 
@@ -2999,8 +4755,8 @@ namespace detail {
             {
                 if (!val.is_array())
                 {
-                    eval_context<Json> new_context{ context.temp_storage_, context.variables_ };
-                    Json j(json_const_pointer_arg, evaluate_tokens(val, token_list_, new_context, ec));
+                    eval_context<Json> new_context{ context.temp_storage_, context };
+                    Json j(json_const_pointer_arg, program_.evaluate(val, new_context, ec));
                     if (is_true(j))
                     {
                         reference jj = this->apply_expressions(val, context, ec);
@@ -3012,21 +4768,78 @@ namespace detail {
                     return context.null_value();
                 }
                 auto result = context.create_json(json_array_arg);
+                if (!condition_.empty())
+                {
+                    evaluate_blocks(val, *result, context, ec);
+                    return *result;
+                }
 
                 for (auto& item : val.array_range())
                 {
-                    eval_context<Json> new_context{ context.temp_storage_, context.variables_ };
-                    Json j(json_const_pointer_arg, evaluate_tokens(item, token_list_, new_context, ec));
-                    if (is_true(j))
+                    select(item, *result, context, ec);
+                }
+                return *result;
+            }
+
+        private:
+            void select(reference item, Json& result, eval_context<Json>& context, std::error_code& ec) const
+            {
+                eval_context<Json> new_context{ context.temp_storage_, context };
+                Json j(json_const_pointer_arg, program_.evaluate(item, new_context, ec));
+                if (is_true(j))
+                {
+                    accept(item, result, context, ec);
+                }
+            }
+
+            void accept(reference item, Json& result, eval_context<Json>& context, std::error_code& ec) const
+            {
+                reference jj = this->apply_expressions(item, context, ec);
+                if (!jj.is_null())
+                {
+                    result.emplace_back(json_const_pointer_arg, std::addressof(jj));
+                }
+            }
+
+            void evaluate_blocks(reference val, Json& result, eval_context<Json>& context, std::error_code& ec) const
+            {
+                const std::size_t block_size = numeric_condition::block_size;
+                const Json* elements[block_size];
+                uint8_t selection[block_size];
+                std::vector<uint8_t> masks(condition_.max_depth()*block_size);
+
+                auto range = val.array_range();
+                auto it = range.begin();
+                while (it != range.end())
+                {
+                    std::size_t n = 0;
+                    for (; n < block_size && it != range.end(); ++n, ++it)
                     {
-                        reference jj = this->apply_expressions(item, context, ec);
-                        if (!jj.is_null())
+                        elements[n] = std::addressof(*it);
+                    }
+                    condition_.evaluate(elements, n, selection, masks.data());
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        if (selection[i] == numeric_condition::selected)
+                        {
+                            accept(*elements[i], result, context, ec);
+                        }
+                        else if (selection[i] == numeric_condition::undecided)
                         {
-                            result->emplace_back(json_const_pointer_arg, std::addressof(jj));
+                            select(*elements[i], result, context, ec);
                         }
                     }
                 }
-                return *result;
+            }
+        public:
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "filter_projection\n";
+                dump_indent(os, indent+1);
+                os << "condition\n";
+                dump_tokens(program_.tokens(), os, indent+2);
+                this->dump_expressions(os, indent+1);
             }
         };
 
@@ -3046,6 +4859,38 @@ namespace detail {
                 }
 
                 auto result = context.create_json(json_array_arg);
+                if (context.pool() != nullptr)
+                {
+                    std::size_t count = 0;
+                    for (reference current_elem : val.array_range())
+                    {
+                        count += current_elem.is_array() ? current_elem.size() : 1;
+                    }
+                    if (this->is_parallel(context, count))
+                    {
+                        std::vector<pointer> elements;
+                        elements.reserve(count);
+                        for (reference current_elem : val.array_range())
+                        {
+                            if (current_elem.is_array())
+                            {
+                                for (reference elem : current_elem.array_range())
+                                {
+                                    if (!elem.is_null())
+                                    {
+                                        elements.push_back(std::addressof(elem));
+                                    }
+                                }
+                            }
+                            else if (!current_elem.is_null())
+                            {
+                                elements.push_back(std::addressof(current_elem));
+                            }
+                        }
+                        this->apply_expressions(elements, *result, context, ec);
+                        return *result;
+                    }
+                }
                 for (reference current_elem : val.array_range())
                 {
                     if (current_elem.is_array())
@@ -3076,15 +4921,38 @@ namespace detail {
                 }
                 return *result;
             }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "flatten_projection\n";
+                this->dump_expressions(os, indent+1);
+            }
         };
 
         class multi_select_list final : public basic_expression
         {
-            std::vector<std::vector<token<Json>>> token_lists_;
+            std::vector<token_program> programs_;
         public:
             multi_select_list(std::vector<std::vector<token<Json>>>&& token_lists)
-                : token_lists_(std::move(token_lists))
             {
+                programs_.reserve(token_lists.size());
+                for (auto& list : token_lists)
+                {
+                    programs_.emplace_back(std::move(list));
+                }
+            }
+
+            bool input_paths(std::vector<std::vector<string_type>>& paths) const override
+            {
+                for (auto& program : programs_)
+                {
+                    if (!token_paths(program.tokens(), paths))
+                    {
+                        return false;
+                    }
+                }
+                return true;
             }
 
             reference evaluate(reference val, eval_context<Json>& context, std::error_code& ec) const override
@@ -3094,41 +4962,63 @@ namespace detail {
                     return val;
                 }
                 auto result = context.create_json(json_array_arg);
-                result->reserve(token_lists_.size());
+                result->reserve(programs_.size());
 
-                for (auto& list : token_lists_)
+                for (auto& program : programs_)
                 {
-                    eval_context<Json> new_context{ context.temp_storage_, context.variables_ };
-                    result->emplace_back(json_const_pointer_arg, evaluate_tokens(val, list, new_context, ec));
+                    eval_context<Json> new_context{ context.temp_storage_, context };
+                    result->emplace_back(json_const_pointer_arg, program.evaluate(val, new_context, ec));
                 }
                 return *result;
             }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "multi_select_list\n";
+                for (auto& program : programs_)
+                {
+                    dump_indent(os, indent+1);
+                    os << "item\n";
+                    dump_tokens(program.tokens(), os, indent+2);
+                }
+            }
         };
 
         class variable_expression final : public basic_expression
         {
-            std::vector<token<Json>> tokens_;
+            token_program program_;
         public:
             variable_expression(std::vector<token<Json>>&& tokens)
-                : tokens_(std::move(tokens))
+                : program_(std::move(tokens))
+            {
+            }
+
+            bool input_paths(std::vector<std::vector<string_type>>& paths) const override
             {
+                return token_paths(program_.tokens(), paths);
             }
 
             reference evaluate(reference val, eval_context<Json>& context, std::error_code& ec) const override
             {
-                eval_context<Json> new_context{ context.temp_storage_, context.variables_ };
-                auto ptr = evaluate_tokens(val, tokens_, new_context, ec);
+                eval_context<Json> new_context{ context.temp_storage_, context };
+                auto ptr = program_.evaluate(val, new_context, ec);
                 return *ptr;
             }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_tokens(program_.tokens(), os, indent);
+            }
         };
 
         struct key_tokens
         {
             string_type key;
-            std::vector<token<Json>> tokens;
+            token_program program;
 
             key_tokens(string_type&& Key, std::vector<token<Json>>&& Tokens) noexcept
-                : key(std::move(Key)), tokens(std::move(Tokens))
+                : key(std::move(Key)), program(std::move(Tokens))
             {
             }
         };
@@ -3143,6 +5033,18 @@ namespace detail {
             {
             }
 
+            bool input_paths(std::vector<std::vector<string_type>>& paths) const override
+            {
+                for (auto& item : key_toks_)
+                {
+                    if (!token_paths(item.program.tokens(), paths))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
             reference evaluate(reference val, eval_context<Json>& context, std::error_code& ec) const override
             {
                 if (val.is_null())
@@ -3153,28 +5055,57 @@ namespace detail {
                 resultp->reserve(key_toks_.size());
                 for (auto& item : key_toks_)
                 {
-                    eval_context<Json> new_context{ context.temp_storage_, context.variables_ };
-                    resultp->try_emplace(item.key, json_const_pointer_arg, evaluate_tokens(val, item.tokens, new_context, ec));
+                    eval_context<Json> new_context{ context.temp_storage_, context };
+                    resultp->try_emplace(item.key, json_const_pointer_arg, item.program.evaluate(val, new_context, ec));
                 }
 
                 return *resultp;
             }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "multi_select_hash\n";
+                for (auto& item : key_toks_)
+                {
+                    dump_indent(os, indent+1);
+                    os << "key " << item.key << "\n";
+                    dump_tokens(item.program.tokens(), os, indent+2);
+                }
+            }
         };
 
         class function_expression final : public basic_expression
         {
         public:
-            std::vector<token<Json>> toks_;
+            token_program program_;
 
             function_expression(std::vector<token<Json>>&& toks)
-                : toks_(std::move(toks))
+                : program_(std::move(toks))
+            {
+            }
+
+            bool input_paths(std::vector<std::vector<string_type>>& paths) const override
             {
+                return token_paths(program_.tokens(), paths);
             }
 
             reference evaluate(reference val, eval_context<Json>& context, std::error_code& ec) const override
             {
-                eval_context<Json> new_context{ context.temp_storage_, context.variables_ };
-                return *evaluate_tokens(val, toks_, new_context, ec);
+                eval_context<Json> new_context{ context.temp_storage_, context };
+                return *program_.evaluate(val, new_context, ec);
+            }
+
+            const Json* constant_value() const override
+            {
+                return program_.constant_value();
+            }
+
+            void dump(std::basic_ostream<char_type>& os, std::size_t indent) const override
+            {
+                dump_indent(os, indent);
+                os << "function_expression\n";
+                dump_tokens(program_.tokens(), os, indent+1);
             }
         };
 
@@ -3362,7 +5293,8 @@ namespace detail {
         {
         public:
             static_resources resources_;
-            std::vector<token<Json>> output_stack_;
+            token_program program_;
+            parameter_schema<Json> schema_;
         public:
             jmespath_expression() = default;
 
@@ -3371,19 +5303,56 @@ namespace detail {
 
             jmespath_expression(jmespath_expression&& expr)
                 : resources_(std::move(expr.resources_)),
-                  output_stack_(std::move(expr.output_stack_))
+                  program_(std::move(expr.program_)),
+                  schema_(std::move(expr.schema_))
             {
             }
 
             jmespath_expression(static_resources&& resources,
-                std::vector<token<Json>>&& output_stack)
-                : resources_(std::move(resources)), output_stack_(std::move(output_stack))
+                std::vector<token<Json>>&& output_stack,
+                const parameter_schema<Json>& schema = parameter_schema<Json>{})
+                : resources_(std::move(resources)), program_(std::move(output_stack)), schema_(schema)
+            {
+            }
+
+            // Schema the expression was compiled against
+            const parameter_schema<Json>& schema() const
+            {
+                return schema_;
+            }
+
+            // Collects the chains of field names read from the root document, e.g. {{"a","b"},{"c"}}
+            // for "a.b == c". Returns false if the root may be read in any other way (as a whole,
+            // through a projection or a function of @), in which case paths is unspecified.
+            bool root_paths(std::vector<std::vector<string_type>>& paths) const
+            {
+                return token_paths(program_.tokens(), paths);
+            }
+
+            // The field names of the chain the expression starts with, e.g. {"a","b"} for
+            // "a.b[0] == c". An evaluation can start from the value of any prefix of it, so that
+            // expressions sharing a prefix look it up once, see evaluate_from.
+            std::vector<string_type> leading_path() const
             {
+                std::vector<string_type> path;
+                const auto& tokens = program_.tokens();
+                for (std::size_t i = 1; i <= program_.leading_path_length(); ++i)
+                {
+                    path.push_back(*tokens[i].expression_->identifier());
+                }
+                return path;
+            }
+
+            // Writes the optimized plan for debugging, one line per token with nested expressions
+            // indented further
+            void dump(std::basic_ostream<char_type>& os) const
+            {
+                dump_tokens(program_.tokens(), os, 0);
             }
 
             Json evaluate(reference doc) const
             {
-                if (output_stack_.empty())
+                if (program_.empty())
                 {
                     return Json::null();
                 }
@@ -3399,7 +5368,7 @@ namespace detail {
             Json evaluate(reference doc, 
                 const std::map<string_type,Json>& params) const
             {
-                if (output_stack_.empty())
+                if (program_.empty())
                 {
                     return Json::null();
                 }
@@ -3414,31 +5383,174 @@ namespace detail {
 
             Json evaluate(reference doc, std::error_code& ec) const
             {
-                if (output_stack_.empty())
+                if (program_.empty())
                 {
                     return Json::null();
                 }
-                std::vector<std::unique_ptr<Json>> temp_storage;
-                eval_context<Json> context{temp_storage};
-                return deep_copy(*evaluate_tokens(doc, output_stack_, context, ec));
+                temp_json_scope<Json> scope;
+                eval_context<Json> context{scope.storage()};
+                return deep_copy(*program_.evaluate(doc, context, ec));
             }
 
             Json evaluate(reference doc, 
                 const std::map<string_type,Json>& params,
                 std::error_code& ec) const
             {
-                if (output_stack_.empty())
+                if (program_.empty())
+                {
+                    return Json::null();
+                }
+                temp_json_scope<Json> scope;
+                eval_context<Json> context{scope.storage()};
+                for (const auto& param : params)
+                {
+                    context.set_variable(param.first, param.second);
+                }
+
+                return deep_copy(*program_.evaluate(doc, context, ec));
+            }
+
+            // Evaluates with the values of the parameters of schema(), in slot order
+            Json evaluate(reference doc, 
+                jsoncons::span<const Json> params) const
+            {
+                if (program_.empty())
+                {
+                    return Json::null();
+                }
+                std::error_code ec;
+                Json result = evaluate(doc, params, ec);
+                if (JSONCONS_UNLIKELY(ec))
+                {
+                    JSONCONS_THROW(jmespath_error(ec));
+                }
+                return result;
+            }
+
+            Json evaluate(reference doc, 
+                jsoncons::span<const Json> params,
+                std::error_code& ec) const
+            {
+                if (program_.empty())
                 {
                     return Json::null();
                 }
-                std::vector<std::unique_ptr<Json>> temp_storage;
-                eval_context<Json> context{temp_storage};
+                temp_json_scope<Json> scope;
+                eval_context<Json> context{scope.storage(), schema_, params};
+                return deep_copy(*program_.evaluate(doc, context, ec));
+            }
+
+            // Evaluates with the first path_length field names of leading_path() already looked up
+            // in doc, giving path_value (null where a field is missing)
+            Json evaluate_from(reference doc, 
+                std::size_t path_length,
+                reference path_value,
+                jsoncons::span<const Json> params) const
+            {
+                std::error_code ec;
+                Json result = evaluate_from(doc, path_length, path_value, params, ec);
+                if (JSONCONS_UNLIKELY(ec))
+                {
+                    JSONCONS_THROW(jmespath_error(ec));
+                }
+                return result;
+            }
+
+            Json evaluate_from(reference doc, 
+                std::size_t path_length,
+                reference path_value,
+                jsoncons::span<const Json> params,
+                std::error_code& ec) const
+            {
+                if (program_.empty())
+                {
+                    return Json::null();
+                }
+                temp_json_scope<Json> scope;
+                eval_context<Json> context{scope.storage(), schema_, params};
+                return deep_copy(*program_.evaluate_from(doc, path_length, path_value, context, ec));
+            }
+
+            // The evaluate_ref overloads return a result that refers into doc and params rather
+            // than a copy, see evaluation_result
+
+            evaluation_result<Json> evaluate_ref(reference doc) const
+            {
+                std::error_code ec;
+                auto result = evaluate_ref(doc, ec);
+                if (JSONCONS_UNLIKELY(ec))
+                {
+                    JSONCONS_THROW(jmespath_error(ec));
+                }
+                return result;
+            }
+
+            evaluation_result<Json> evaluate_ref(reference doc, 
+                const std::map<string_type,Json>& params) const
+            {
+                std::error_code ec;
+                auto result = evaluate_ref(doc, params, ec);
+                if (JSONCONS_UNLIKELY(ec))
+                {
+                    JSONCONS_THROW(jmespath_error(ec));
+                }
+                return result;
+            }
+
+            evaluation_result<Json> evaluate_ref(reference doc, 
+                jsoncons::span<const Json> params) const
+            {
+                std::error_code ec;
+                auto result = evaluate_ref(doc, params, ec);
+                if (JSONCONS_UNLIKELY(ec))
+                {
+                    JSONCONS_THROW(jmespath_error(ec));
+                }
+                return result;
+            }
+
+            evaluation_result<Json> evaluate_ref(reference doc, std::error_code& ec) const
+            {
+                if (program_.empty())
+                {
+                    return evaluation_result<Json>{};
+                }
+                std::unique_ptr<temp_json_storage<Json>> storage(new temp_json_storage<Json>());
+                eval_context<Json> context{*storage};
+                reference value = *program_.evaluate(doc, context, ec);
+                return evaluation_result<Json>(std::move(storage), value);
+            }
+
+            evaluation_result<Json> evaluate_ref(reference doc, 
+                const std::map<string_type,Json>& params,
+                std::error_code& ec) const
+            {
+                if (program_.empty())
+                {
+                    return evaluation_result<Json>{};
+                }
+                std::unique_ptr<temp_json_storage<Json>> storage(new temp_json_storage<Json>());
+                eval_context<Json> context{*storage};
                 for (const auto& param : params)
                 {
                     context.set_variable(param.first, param.second);
                 }
+                reference value = *program_.evaluate(doc, context, ec);
+                return evaluation_result<Json>(std::move(storage), value);
+            }
 
-                return deep_copy(*evaluate_tokens(doc, output_stack_, context, ec));
+            evaluation_result<Json> evaluate_ref(reference doc, 
+                jsoncons::span<const Json> params,
+                std::error_code& ec) const
+            {
+                if (program_.empty())
+                {
+                    return evaluation_result<Json>{};
+                }
+                std::unique_ptr<temp_json_storage<Json>> storage(new temp_json_storage<Json>());
+                eval_context<Json> context{*storage, schema_, params};
+                reference value = *program_.evaluate(doc, context, ec);
+                return evaluation_result<Json>(std::move(storage), value);
             }
         };
     public:
@@ -3448,6 +5560,9 @@ namespace detail {
         const char_type* input_end_{nullptr};
         const char_type* p_{nullptr};
         std::vector<token<Json>> operator_stack_;
+        const parameter_schema<Json>* schema_{nullptr};
+        // Variables bound by a let seen so far, references to them are looked up by name
+        std::vector<string_type> let_names_;
 
     public:
         jmespath_evaluator()
@@ -3466,6 +5581,28 @@ namespace detail {
             return column_;
         }
 
+        // Slot of a reference to a declared parameter, unless a let seen so far binds the same name
+        std::size_t parameter_slot(const string_type& name) const
+        {
+            if (schema_ == nullptr || std::find(let_names_.begin(), let_names_.end(), name) != let_names_.end())
+            {
+                return token<Json>::no_slot;
+            }
+            std::size_t slot = schema_->find(name);
+            return slot < schema_->size() ? slot : token<Json>::no_slot;
+        }
+
+        jmespath_expression compile(const char_type* path, std::size_t length, 
+            const jsoncons::jmespath::custom_functions<Json>& funcs, 
+            const parameter_schema<Json>& schema,
+            std::error_code& ec)
+        {
+            schema_ = std::addressof(schema);
+            auto expr = compile(path, length, funcs, ec);
+            schema_ = nullptr;
+            return expr;
+        }
+
         jmespath_expression compile(const char_type* path, std::size_t length, 
             const jsoncons::jmespath::custom_functions<Json>& funcs, 
             std::error_code& ec)
@@ -3604,7 +5741,7 @@ namespace detail {
                         break;
                     case expr_state::substitute_variable:
                     {
-                        push_token(token<Json>{variable_binding_arg, buffer},
+                        push_token(token<Json>{variable_binding_arg, buffer, parameter_slot(buffer)},
                             resources, output_stack, ec);
                         if (JSONCONS_UNLIKELY(ec))
                         {
@@ -3875,6 +6012,7 @@ namespace detail {
                                 
                                 context_stack.back().end_index = output_stack.size();
                                 context_stack.back().variable_ref = buffer;
+                                let_names_.push_back(buffer);
                                 state_stack.back() = expr_state::expect_in_or_comma;
                                 state_stack.push_back(expr_state::rhs_expression);
                                 state_stack.push_back(expr_state::lhs_expression);
@@ -4973,7 +7111,7 @@ namespace detail {
                         break;
                     case expr_state::substitute_variable:
                     {
-                        push_token(token<Json>{variable_binding_arg, buffer},
+                        push_token(token<Json>{variable_binding_arg, buffer, parameter_slot(buffer)},
                             resources, output_stack, ec);
                         if (JSONCONS_UNLIKELY(ec))
                         {
@@ -5023,6 +7161,10 @@ namespace detail {
                 output_stack.insert(output_stack.begin(), token<Json>{current_node_arg});
             }
             
+            if (schema_ != nullptr)
+            {
+                return jmespath_expression{ std::move(resources), std::move(output_stack), *schema_ };
+            }
             return jmespath_expression{ std::move(resources), std::move(output_stack) };
         }
 
@@ -5495,6 +7637,31 @@ namespace detail {
         return evaluator.compile(expr.data(), expr.size(), funcs, ec);
     }
 
+    template <typename Json>
+    jmespath_expression<Json> make_expression(const typename Json::string_view_type& expr,
+        const parameter_schema<Json>& schema,
+        const jsoncons::jmespath::custom_functions<Json>& funcs = jsoncons::jmespath::custom_functions<Json>())
+    {
+        jsoncons::jmespath::detail::jmespath_evaluator<Json> evaluator{};
+        std::error_code ec;
+        auto compiled = evaluator.compile(expr.data(), expr.size(), funcs, schema, ec);
+        if (JSONCONS_UNLIKELY(ec))
+        {
+            JSONCONS_THROW(jmespath_error(ec, evaluator.line(), evaluator.column()));
+        }
+        return compiled;
+    }
+
+    template <typename Json>
+    jmespath_expression<Json> make_expression(const typename Json::string_view_type& expr,
+        const parameter_schema<Json>& schema,
+        const jsoncons::jmespath::custom_functions<Json>& funcs,
+        std::error_code& ec)
+    {
+        jsoncons::jmespath::detail::jmespath_evaluator<Json> evaluator{};
+        return evaluator.compile(expr.data(), expr.size(), funcs, schema, ec);
+    }
+
 } // namespace jmespath
 } // namespace jsoncons
 
@@ -8,6 +8,7 @@
 #define JSONCONS_EXT_MSGPACK_DECODE_MSGPACK_HPP
 
 #include <istream> // std::basic_istream
+#include <memory> // std::addressof
 #include <type_traits> // std::enable_if
 
 #include <jsoncons/allocator_set.hpp>
@@ -51,6 +52,34 @@ try_decode_msgpack(const BytesLike& v,
     return result_type{decoder.get_result()};
 }
 
+// Decodes only the map members selected by projection, skipping the bytes of all others
+template <typename T,typename BytesLike>
+typename std::enable_if<ext_traits::is_basic_json<T>::value &&
+                        ext_traits::is_byte_sequence<BytesLike>::value,read_result<T>>::type 
+try_decode_msgpack(const BytesLike& v, 
+    const msgpack_projection& projection,
+    const msgpack_decode_options& options = msgpack_decode_options())
+{
+    using value_type = T;
+    using result_type = read_result<value_type>;
+
+    std::error_code ec;   
+    jsoncons::json_decoder<T> decoder;
+    auto adaptor = make_json_visitor_adaptor<json_visitor>(decoder);
+    basic_msgpack_reader<jsoncons::bytes_source> reader(v, adaptor, options);
+    reader.projection(std::addressof(projection));
+    reader.read(ec);
+    if (JSONCONS_UNLIKELY(ec))
+    {
+        return result_type{jsoncons::unexpect, ec, reader.line(), reader.column()};
+    }
+    if (JSONCONS_UNLIKELY(!decoder.is_valid()))
+    {
+        return result_type{jsoncons::unexpect, conv_errc::conversion_failed, reader.line(), reader.column()};
+    }
+    return result_type{decoder.get_result()};
+}
+
 template <typename T,typename BytesLike>
 typename std::enable_if<!ext_traits::is_basic_json<T>::value &&
                         ext_traits::is_byte_sequence<BytesLike>::value,read_result<T>>::type 
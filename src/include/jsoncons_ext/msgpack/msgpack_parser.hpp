@@ -29,6 +29,7 @@
 
 #include <jsoncons_ext/msgpack/msgpack_error.hpp>
 #include <jsoncons_ext/msgpack/msgpack_options.hpp>
+#include <jsoncons_ext/msgpack/msgpack_projection.hpp>
 #include <jsoncons_ext/msgpack/msgpack_type.hpp>
 
 namespace jsoncons { 
@@ -41,6 +42,7 @@ struct parse_state
     parse_mode mode; 
     std::size_t length{0};
     std::size_t index{0};
+    const msgpack_projection* projection{nullptr}; // selected members of a map, nullptr for all
 
     parse_state(parse_mode mode, std::size_t length) noexcept
         : mode(mode), length(length)
@@ -77,6 +79,8 @@ class basic_msgpack_parser : public ser_context
     std::basic_string<char,std::char_traits<char>,char_allocator_type> text_buffer_;
     std::vector<uint8_t,byte_allocator_type> bytes_buffer_;
     std::vector<parse_state,parse_state_allocator_type> state_stack_;
+    const msgpack_projection* projection_{nullptr};
+    const msgpack_projection* next_projection_{nullptr}; // applies to the next item read
 
 public:
     template <typename Sourceable>
@@ -106,6 +110,7 @@ public:
         state_stack_.clear();
         state_stack_.emplace_back(parse_mode::root,0);
         nesting_depth_ = 0;
+        next_projection_ = projection_;
     }
 
     template <typename Sourceable>
@@ -120,6 +125,14 @@ public:
         cursor_mode_ = value;
     }
 
+    // Only report the map members selected by projection, skipping the bytes of all others.
+    // The projection must outlive the parse; nullptr reports everything.
+    void projection(const msgpack_projection* value)
+    {
+        projection_ = value;
+        next_projection_ = value;
+    }
+
     int level() const
     {
         return static_cast<int>(state_stack_.size());
@@ -184,7 +197,14 @@ public:
                     {
                         ++state_stack_.back().index;
                         state_stack_.back().mode = parse_mode::map_value;
-                        read_item(visitor, ec);
+                        if (state_stack_.back().projection != nullptr)
+                        {
+                            read_projected_key(visitor, ec);
+                        }
+                        else
+                        {
+                            read_item(visitor, ec);
+                        }
                         if (JSONCONS_UNLIKELY(ec))
                         {
                             return;
@@ -239,6 +259,9 @@ private:
             return;
         }   
 
+        const msgpack_projection* projection = next_projection_;
+        next_projection_ = nullptr;
+
         uint8_t type;
         if (source_.read(&type, 1) == 0)
         {
@@ -257,7 +280,7 @@ private:
             }
             else if (type <= 0x8f) 
             {
-                begin_object(visitor,type,ec); // fixmap
+                begin_object(visitor,type,projection,ec); // fixmap
             }
             else if (type <= 0x9f) 
             {
@@ -268,23 +291,22 @@ private:
                 // fixstr
                 const size_t len = type & 0x1f;
 
-                text_buffer_.clear();
-
-                if (source_reader<Source>::read(source_,text_buffer_,len) != static_cast<std::size_t>(len))
+                jsoncons::basic_string_view<char> text;
+                if (!read_text(len, text))
                 {
                     ec = msgpack_errc::unexpected_eof;
                     more_ = false;
                     return;
                 }
 
-                auto result = unicode_traits::validate(text_buffer_.data(),text_buffer_.size());
+                auto result = unicode_traits::validate(text.data(),text.size());
                 if (result.ec != unicode_traits::conv_errc())
                 {
                     ec = msgpack_errc::invalid_utf8_text_string;
                     more_ = false;
                     return;
                 }
-                visitor.string_value(jsoncons::basic_string_view<char>(text_buffer_.data(),text_buffer_.length()), semantic_tag::none, *this, ec);
+                visitor.string_value(text, semantic_tag::none, *this, ec);
                 more_ = !cursor_mode_;
             }
         }
@@ -475,22 +497,22 @@ private:
                         return;
                     }
 
-                    text_buffer_.clear();
-                    if (source_reader<Source>::read(source_,text_buffer_,len) != static_cast<std::size_t>(len))
+                    jsoncons::basic_string_view<char> text;
+                    if (!read_text(len, text))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         more_ = false;
                         return;
                     }
 
-                    auto result = unicode_traits::validate(text_buffer_.data(),text_buffer_.size());
+                    auto result = unicode_traits::validate(text.data(),text.size());
                     if (result.ec != unicode_traits::conv_errc())
                     {
                         ec = msgpack_errc::invalid_utf8_text_string;
                         more_ = false;
                         return;
                     }
-                    visitor.string_value(jsoncons::basic_string_view<char>(text_buffer_.data(),text_buffer_.length()), semantic_tag::none, *this, ec);
+                    visitor.string_value(text, semantic_tag::none, *this, ec);
                     more_ = !cursor_mode_;
                     break;
                 }
@@ -504,15 +526,15 @@ private:
                     {
                         return;
                     }
-                    bytes_buffer_.clear();
-                    if (source_reader<Source>::read(source_,bytes_buffer_,len) != static_cast<std::size_t>(len))
+                    byte_string_view bytes;
+                    if (!read_bytes(len, bytes))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         more_ = false;
                         return;
                     }
 
-                    visitor.byte_string_value(byte_string_view(bytes_buffer_.data(),bytes_buffer_.size()), 
+                    visitor.byte_string_value(bytes, 
                                                       semantic_tag::none, 
                                                       *this,
                                                       ec);
@@ -655,7 +677,7 @@ private:
                 case jsoncons::msgpack::msgpack_type::map16_type : 
                 case jsoncons::msgpack::msgpack_type::map32_type : 
                 {
-                    begin_object(visitor, type, ec);
+                    begin_object(visitor, type, projection, ec);
                     break;
                 }
 
@@ -696,7 +718,7 @@ private:
         state_stack_.pop_back();
     }
 
-    void begin_object(item_event_visitor& visitor, uint8_t type, std::error_code& ec)
+    void begin_object(item_event_visitor& visitor, uint8_t type, const msgpack_projection* projection, std::error_code& ec)
     {
         if (JSONCONS_UNLIKELY(++nesting_depth_ > max_nesting_depth_))
         {
@@ -710,10 +732,110 @@ private:
             return;
         }
         state_stack_.emplace_back(parse_mode::map_key,length);
-        visitor.begin_object(length, semantic_tag::none, *this, ec);
+        if (projection != nullptr && !projection->selects_all())
+        {
+            // the number of members reported is not known up front
+            state_stack_.back().projection = projection;
+            visitor.begin_object(semantic_tag::none, *this, ec);
+        }
+        else
+        {
+            visitor.begin_object(length, semantic_tag::none, *this, ec);
+        }
         more_ = !cursor_mode_;
     }
 
+    // Reads a key of a map parsed under a projection. A member the projection does not select
+    // is skipped, key and value, without reporting anything to the visitor.
+    void read_projected_key(item_event_visitor& visitor, std::error_code& ec)
+    {
+        auto c = source_.peek();
+        if (c.eof)
+        {
+            ec = msgpack_errc::unexpected_eof;
+            more_ = false;
+            return;
+        }
+        const uint8_t type = c.value;
+        const bool is_str = (type >= msgpack_type::fixstr_base_type && type <= 0xbf) ||
+                            type == msgpack_type::str8_type || type == msgpack_type::str16_type || type == msgpack_type::str32_type;
+        if (!is_str)
+        {
+            // keep members with other keys whole
+            read_item(visitor, ec);
+            return;
+        }
+        source_.ignore(1);
+        std::size_t len = type <= 0xbf ? (type & 0x1f) : get_size(type, ec);
+        if (!more_)
+        {
+            return;
+        }
+        jsoncons::basic_string_view<char> text;
+        if (!read_text(len, text))
+        {
+            ec = msgpack_errc::unexpected_eof;
+            more_ = false;
+            return;
+        }
+        const msgpack_projection* child = state_stack_.back().projection->find(text);
+        if (child == nullptr)
+        {
+            state_stack_.back().mode = parse_mode::map_key;
+            skip_item(ec);
+            return;
+        }
+        auto result = unicode_traits::validate(text.data(),text.size());
+        if (result.ec != unicode_traits::conv_errc())
+        {
+            ec = msgpack_errc::invalid_utf8_text_string;
+            more_ = false;
+            return;
+        }
+        next_projection_ = child;
+        visitor.string_value(text, semantic_tag::none, *this, ec);
+        more_ = !cursor_mode_;
+    }
+
+    // Skips over the next item, including everything nested in it, reading only headers
+    void skip_item(std::error_code& ec)
+    {
+        std::size_t pending = 1;
+        while (pending > 0)
+        {
+            uint8_t buf[5];
+            if (source_.read(buf, 1) != 1)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                more_ = false;
+                return;
+            }
+            const std::size_t width = detail::msgpack_length_width(buf[0]);
+            if (width > 0 && source_.read(buf + 1, width) != width)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                more_ = false;
+                return;
+            }
+            detail::msgpack_header h;
+            if (!detail::read_msgpack_header(buf, buf + 1 + width, h, ec))
+            {
+                more_ = false;
+                return;
+            }
+            const std::size_t count = h.header_length - 1 - width + h.payload_length;
+            const std::size_t position = source_.position();
+            source_.ignore(count);
+            if (source_.position() - position != count)
+            {
+                ec = msgpack_errc::unexpected_eof;
+                more_ = false;
+                return;
+            }
+            pending = pending - 1 + h.items;
+        }
+    }
+
     void end_object(item_event_visitor& visitor, std::error_code& ec)
     {
         --nesting_depth_;
@@ -722,6 +844,51 @@ private:
         state_stack_.pop_back();
     }
 
+    // Sources over contiguous memory hand out views into the input, others are copied into text_buffer_
+    template <typename S = Source>
+    typename std::enable_if<has_read_span<S>::value,bool>::type
+    read_text(std::size_t len, jsoncons::basic_string_view<char>& text)
+    {
+        auto s = source_.read_span(len);
+        text = jsoncons::basic_string_view<char>(reinterpret_cast<const char*>(s.data()), s.size());
+        return s.size() == len;
+    }
+
+    template <typename S = Source>
+    typename std::enable_if<!has_read_span<S>::value,bool>::type
+    read_text(std::size_t len, jsoncons::basic_string_view<char>& text)
+    {
+        text_buffer_.clear();
+        if (source_reader<Source>::read(source_,text_buffer_,len) != len)
+        {
+            return false;
+        }
+        text = jsoncons::basic_string_view<char>(text_buffer_.data(), text_buffer_.length());
+        return true;
+    }
+
+    template <typename S = Source>
+    typename std::enable_if<has_read_span<S>::value,bool>::type
+    read_bytes(std::size_t len, byte_string_view& bytes)
+    {
+        auto s = source_.read_span(len);
+        bytes = byte_string_view(s.data(), s.size());
+        return s.size() == len;
+    }
+
+    template <typename S = Source>
+    typename std::enable_if<!has_read_span<S>::value,bool>::type
+    read_bytes(std::size_t len, byte_string_view& bytes)
+    {
+        bytes_buffer_.clear();
+        if (source_reader<Source>::read(source_,bytes_buffer_,len) != len)
+        {
+            return false;
+        }
+        bytes = byte_string_view(bytes_buffer_.data(), bytes_buffer_.size());
+        return true;
+    }
+
     std::size_t get_size(uint8_t type, std::error_code& ec)
     {
         switch (type)
@@ -0,0 +1,87 @@
+// Copyright 2013-2026 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_EXT_MSGPACK_MSGPACK_PROJECTION_HPP
+#define JSONCONS_EXT_MSGPACK_MSGPACK_PROJECTION_HPP
+
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+
+#include <jsoncons/config/jsoncons_config.hpp>
+
+namespace jsoncons { 
+namespace msgpack {
+
+    // A tree of map member names selected for decoding. When parsing with a projection, members
+    // of a map that the tree does not select are skipped at the byte level without being decoded.
+    // A node without children selects the whole value, and a node with children applied to a
+    // value that is not a map also keeps it whole.
+    class msgpack_projection
+    {
+        std::vector<std::pair<std::string,msgpack_projection>> children_;
+        bool all_{false};
+    public:
+        msgpack_projection() = default;
+
+        // Selects the value reached by following names from the root
+        void add(const std::vector<std::string>& names)
+        {
+            msgpack_projection* node = this;
+            for (const auto& name : names)
+            {
+                if (node->all_)
+                {
+                    return;
+                }
+                msgpack_projection* child = node->find_child(name);
+                if (child == nullptr)
+                {
+                    node->children_.emplace_back(name, msgpack_projection());
+                    child = &node->children_.back().second;
+                }
+                node = child;
+            }
+            node->all_ = true;
+            node->children_.clear();
+        }
+
+        bool selects_all() const
+        {
+            return all_;
+        }
+
+        // The node for a member of a map, or nullptr if the member is not selected
+        const msgpack_projection* find(const jsoncons::string_view& name) const
+        {
+            for (const auto& child : children_)
+            {
+                if (name == child.first)
+                {
+                    return &child.second;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        msgpack_projection* find_child(const std::string& name)
+        {
+            for (auto& child : children_)
+            {
+                if (child.first == name)
+                {
+                    return &child.second;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+} // namespace msgpack
+} // namespace jsoncons
+
+#endif // JSONCONS_EXT_MSGPACK_MSGPACK_PROJECTION_HPP
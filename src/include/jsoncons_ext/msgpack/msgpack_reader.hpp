@@ -73,6 +73,12 @@ public:
     {
     }
 
+    // Only report the map members selected by projection, see basic_msgpack_parser::projection
+    void projection(const msgpack_projection* value)
+    {
+        parser_.projection(value);
+    }
+
     void read()
     {
         std::error_code ec;
@@ -7,7 +7,13 @@
 #ifndef JSONCONS_EXT_MSGPACK_MSGPACK_TYPE_HPP
 #define JSONCONS_EXT_MSGPACK_MSGPACK_TYPE_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <system_error>
+
+#include <jsoncons/utility/binary.hpp>
+
+#include <jsoncons_ext/msgpack/msgpack_error.hpp>
 
 namespace jsoncons { 
 namespace msgpack {
@@ -55,6 +61,151 @@ namespace msgpack {
         JSONCONS_INLINE_CONSTEXPR uint8_t map32_type = 0xdf;
         JSONCONS_INLINE_CONSTEXPR uint8_t negative_fixint_base_type = 0xe0;
     }
+
+namespace detail {
+
+    struct msgpack_header
+    {
+        std::size_t header_length{0};  // type byte and length fields
+        std::size_t payload_length{0}; // bytes of string, binary and ext data
+        std::size_t items{0};          // nested items, two per map member
+    };
+
+    // Number of bytes of the length field that follows the type byte of strings, binaries,
+    // extensions, arrays and maps, 0 for all other types
+    inline std::size_t msgpack_length_width(uint8_t type)
+    {
+        switch (type)
+        {
+            case msgpack_type::str8_type:
+            case msgpack_type::bin8_type:
+            case msgpack_type::ext8_type:
+                return 1;
+            case msgpack_type::str16_type:
+            case msgpack_type::bin16_type:
+            case msgpack_type::ext16_type:
+            case msgpack_type::array16_type:
+            case msgpack_type::map16_type:
+                return 2;
+            case msgpack_type::str32_type:
+            case msgpack_type::bin32_type:
+            case msgpack_type::ext32_type:
+            case msgpack_type::array32_type:
+            case msgpack_type::map32_type:
+                return 4;
+            default:
+                return 0;
+        }
+    }
+
+    // Decodes the header of the item at first: the lengths of its header and payload and
+    // the number of items nested directly in it
+    inline bool read_msgpack_header(const uint8_t* first, const uint8_t* last, msgpack_header& h, std::error_code& ec)
+    {
+        if (first >= last)
+        {
+            ec = msgpack_errc::unexpected_eof;
+            return false;
+        }
+        const uint8_t type = *first;
+        const std::size_t avail = static_cast<std::size_t>(last - first);
+        h = msgpack_header{};
+        h.header_length = 1;
+
+        if (type <= 0x7f || type >= msgpack_type::negative_fixint_base_type)
+        {
+            return true;
+        }
+        if (type <= 0x8f)
+        {
+            h.items = 2*(type & 0x0f); // fixmap
+            return true;
+        }
+        if (type <= 0x9f)
+        {
+            h.items = type & 0x0f; // fixarray
+            return true;
+        }
+        if (type <= 0xbf)
+        {
+            h.payload_length = type & 0x1f; // fixstr
+            return true;
+        }
+
+        switch (type)
+        {
+            case msgpack_type::nil_type:
+            case msgpack_type::false_type:
+            case msgpack_type::true_type:
+                return true;
+            case msgpack_type::uint8_type:
+            case msgpack_type::int8_type:
+                h.header_length = 2;
+                return true;
+            case msgpack_type::uint16_type:
+            case msgpack_type::int16_type:
+                h.header_length = 3;
+                return true;
+            case msgpack_type::uint32_type:
+            case msgpack_type::int32_type:
+            case msgpack_type::float32_type:
+                h.header_length = 5;
+                return true;
+            case msgpack_type::uint64_type:
+            case msgpack_type::int64_type:
+            case msgpack_type::float64_type:
+                h.header_length = 9;
+                return true;
+            case msgpack_type::fixext1_type:
+            case msgpack_type::fixext2_type:
+            case msgpack_type::fixext4_type:
+            case msgpack_type::fixext8_type:
+            case msgpack_type::fixext16_type:
+                h.header_length = 2;
+                h.payload_length = std::size_t(1) << (type - msgpack_type::fixext1_type);
+                return true;
+            default:
+                break;
+        }
+        const std::size_t width = msgpack_length_width(type);
+        if (width == 0)
+        {
+            ec = msgpack_errc::unknown_type;
+            return false;
+        }
+        if (avail < 1 + width)
+        {
+            ec = msgpack_errc::unexpected_eof;
+            return false;
+        }
+        std::size_t length = width == 1 ? first[1]
+                           : width == 2 ? binary::big_to_native<uint16_t>(first + 1, 2)
+                           : binary::big_to_native<uint32_t>(first + 1, 4);
+        h.header_length = 1 + width;
+        switch (type)
+        {
+            case msgpack_type::ext8_type:
+            case msgpack_type::ext16_type:
+            case msgpack_type::ext32_type:
+                h.header_length += 1; // ext type
+                h.payload_length = length;
+                break;
+            case msgpack_type::array16_type:
+            case msgpack_type::array32_type:
+                h.items = length;
+                break;
+            case msgpack_type::map16_type:
+            case msgpack_type::map32_type:
+                h.items = 2*length;
+                break;
+            default:
+                h.payload_length = length;
+                break;
+        }
+        return true;
+    }
+
+} // namespace detail
  
 } // namespace msgpack
 } // namespace jsoncons
@@ -10,12 +10,26 @@
 #define STRINGIFY(x) #x
 #define MACRO_STRINGIFY(x) STRINGIFY(x)
 
+// ojson objects with at least this many members keep a hash index of their keys
+#define JSONCONS_ORDER_PRESERVING_INDEX_THRESHOLD 32
+
 #include <jsoncons/json.hpp>
 #include <jsoncons_ext/jmespath/jmespath.hpp>
 #include <jsoncons_ext/msgpack/msgpack.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <deque>
+#include <limits>
+#include <list>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
 using json = jsoncons::ojson; // using json = jsoncons::json;
 namespace jmespath = jsoncons::jmespath;
@@ -168,6 +182,22 @@ namespace pyjson
         std::set<const PyObject*> refs;
         return to_json(obj, refs);
     }
+
+    // View the memory of a Python buffer (bytes, bytearray, memoryview, mmap, ...) without copying,
+    // valid as long as the buffer_info is alive
+    inline std::string_view to_bytes_view(const py::buffer_info& info)
+    {
+        py::ssize_t stride = info.itemsize;
+        for (py::ssize_t i = info.ndim - 1; i >= 0; --i)
+        {
+            if (info.shape[i] > 1 && info.strides[i] != stride)
+            {
+                throw std::runtime_error("Buffer must be C-contiguous");
+            }
+            stride *= info.shape[i];
+        }
+        return std::string_view(static_cast<const char*>(info.ptr), static_cast<size_t>(info.size * info.itemsize));
+    }
 }
 
 /*
@@ -200,6 +230,261 @@ namespace pybind11 { namespace detail {
 }} // namespace pybind11::detail
 */
 
+/**
+ * A bounded, thread-safe LRU cache of compiled JMESPath expressions, shared by JsonQueryRepl,
+ * JsonQuery and JMESPathExpr.build. Entries are keyed by the expression text and the parameters
+ * it was compiled against, and are only evaluated through const references once cached.
+ */
+struct ExpressionCache {
+    using expr_ptr = std::shared_ptr<jmespath_expr_type>;
+
+    explicit ExpressionCache(size_t capacity): capacity_(capacity) { }
+
+    /**
+     * The cache shared by the whole module.
+     */
+    static ExpressionCache &instance() {
+        static ExpressionCache cache(256);
+        return cache;
+    }
+
+    /**
+     * Get the compiled expression, compiling and caching it on a miss.
+     * @param expr_text JMESPath expression
+     * @param schema Parameters the expression is compiled against
+     * @return Compiled expression
+     */
+    expr_ptr get(const std::string &expr_text, const jmespath::parameter_schema<json> &schema = {}) {
+        std::string key = __make_key(expr_text, schema);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (auto expr = __find(key)) {
+                ++hits_;
+                return expr;
+            }
+            ++misses_;
+        }
+        // compile without holding the lock, concurrent misses on one key may both compile it
+        auto expr = std::make_shared<jmespath_expr_type>(jmespath::make_expression<json>(expr_text, schema));
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto cached = __find(key)) {
+            return cached;
+        }
+        if (capacity_ > 0) {
+            entries_.emplace_front(std::move(key), expr);
+            index_.emplace(entries_.front().first, entries_.begin());
+            __evict();
+        }
+        return expr;
+    }
+
+    /**
+     * Set the maximum number of cached expressions, evicting the least recently used ones.
+     * @param capacity Maximum number of expressions, 0 disables caching
+     */
+    void resize(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+        __evict();
+    }
+
+    /**
+     * Drop all cached expressions and reset the counters.
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index_.clear();
+        entries_.clear();
+        hits_ = 0;
+        misses_ = 0;
+    }
+
+    /**
+     * Get the cache statistics.
+     * @return Hits, misses, number of cached expressions and capacity
+     */
+    std::map<std::string, size_t> info() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {{"hits", hits_}, {"misses", misses_}, {"size", entries_.size()}, {"capacity", capacity_}};
+    }
+
+private:
+    // most recently used first, index_ refers to the keys held by entries_
+    std::list<std::pair<std::string, expr_ptr>> entries_;
+    std::unordered_map<std::string_view, std::list<std::pair<std::string, expr_ptr>>::iterator> index_;
+    size_t capacity_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    mutable std::mutex mutex_;
+
+    static std::string __make_key(const std::string &expr_text, const jmespath::parameter_schema<json> &schema) {
+        // length prefixed, so that no expression text can collide with another text and schema
+        std::string key = std::to_string(expr_text.size()) + ':' + expr_text;
+        for (size_t i = 0; i < schema.size(); ++i) {
+            key += std::to_string(schema.name(i).size()) + ':' + schema.name(i);
+        }
+        return key;
+    }
+
+    expr_ptr __find(const std::string &key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    void __evict() {
+        while (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+};
+
+/**
+ * The thread pool that JMESPath evaluations started by JsonQueryRepl and JMESPathExpr split
+ * projections over large arrays and objects on. Evaluation is serial until it is configured.
+ */
+struct ParallelProjections {
+    /**
+     * Makes the evaluations on the current thread use the pool while it exists.
+     */
+    struct Scope {
+        Scope(): pool_(instance().pool()), scope_(pool_.get()) { }
+
+    private:
+        std::shared_ptr<jmespath::projection_pool> pool_;
+        jmespath::projection_pool::scope scope_;
+    };
+
+    static ParallelProjections &instance() {
+        static ParallelProjections projections;
+        return projections;
+    }
+
+    /**
+     * Set the number of threads and the size from which projections are split.
+     * Evaluations already running keep the previous pool until they end.
+     * @param num_threads Number of threads, the evaluating one included, 0 to use all hardware threads, 1 for serial evaluation
+     * @param threshold Minimum number of elements of a projection evaluated in parallel
+     */
+    void configure(int num_threads, size_t threshold) {
+        if (num_threads <= 0) {
+            num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+        std::shared_ptr<jmespath::projection_pool> pool;
+        if (num_threads > 1) {
+            pool = std::make_shared<jmespath::projection_pool>(num_threads - 1, threshold);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool_.swap(pool);
+    }
+
+    /**
+     * Get the current configuration.
+     * @return Number of threads (1 if evaluation is serial) and threshold
+     */
+    std::map<std::string, size_t> info() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!pool_) {
+            return {{"num_threads", 1}, {"threshold", 0}};
+        }
+        return {{"num_threads", pool_->concurrency()}, {"threshold", pool_->threshold()}};
+    }
+
+private:
+    std::shared_ptr<jmespath::projection_pool> pool_;
+    mutable std::mutex mutex_;
+
+    std::shared_ptr<jmespath::projection_pool> pool() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pool_;
+    }
+};
+
+/**
+ * A JMESPath result that refers into documents and parameters instead of copying out of them.
+ * It registers the objects it refers into, and code about to modify or replace one of them
+ * calls release on it first, which turns the results still referring into it into copies.
+ */
+struct BorrowedResult {
+    /**
+     * @param result Result of evaluate_ref
+     * @param sources Objects the result may refer into
+     */
+    BorrowedResult(jmespath::evaluation_result<json> &&result, std::vector<const void *> sources)
+        : result_(std::move(result)), sources_(std::move(sources)) {
+        std::lock_guard<std::mutex> lock(mutex());
+        for (auto source: sources_) {
+            registry().emplace(source, this);
+        }
+    }
+
+    ~BorrowedResult() {
+        std::lock_guard<std::mutex> lock(mutex());
+        __unregister();
+    }
+
+    BorrowedResult(const BorrowedResult &) = delete;
+    BorrowedResult &operator=(const BorrowedResult &) = delete;
+
+    const json &value() const {
+        return owned_ ? *owned_ : result_.value();
+    }
+
+    json copy() const {
+        return owned_ ? *owned_ : result_.copy();
+    }
+
+    /**
+     * Make the results referring into source independent of it, before it is modified.
+     * @param source Document or parameters about to change
+     */
+    static void release(const void *source) {
+        std::lock_guard<std::mutex> lock(mutex());
+        auto range = registry().equal_range(source);
+        std::vector<BorrowedResult *> results;
+        for (auto it = range.first; it != range.second; ++it) {
+            results.push_back(it->second);
+        }
+        for (auto result: results) {
+            result->owned_ = result->result_.copy();
+            result->result_ = jmespath::evaluation_result<json>();
+            result->__unregister();
+        }
+    }
+
+private:
+    jmespath::evaluation_result<json> result_;
+    std::optional<json> owned_; // set once the sources were released
+    std::vector<const void *> sources_;
+
+    static std::mutex &mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::unordered_multimap<const void *, BorrowedResult *> &registry() {
+        static std::unordered_multimap<const void *, BorrowedResult *> registry;
+        return registry;
+    }
+
+    void __unregister() {
+        for (auto source: sources_) {
+            auto range = registry().equal_range(source);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == this) {
+                    registry().erase(it);
+                    break;
+                }
+            }
+        }
+        sources_.clear();
+    }
+};
+
 /**
  * A REPL (Read-Eval-Print Loop) for evaluating JMESPath expressions on JSON data.
  */
@@ -218,141 +503,1010 @@ struct JsonQueryRepl {
      * @return Result of the evaluation as a string
      */
     std::string eval(const std::string &expr_text) const {
-        auto expr = jmespath::make_expression<json>(expr_text);
+        auto expr = ExpressionCache::instance().get(expr_text);
+        ParallelProjections::Scope scope;
+        auto result = expr->evaluate(doc, params_);
+        if (debug) {
+            std::cerr << pretty_print(result) << std::endl;
+        }
+        return result.to_string();
+    }
+
+    /**
+     * Evaluate a JMESPath expression against the JSON document.
+     * @param expr JMESPath expression
+     * @return Result of the evaluation as a json object
+     */
+    json eval_expr(const jmespath_expr_type &expr) const {
+        ParallelProjections::Scope scope;
         auto result = expr.evaluate(doc, params_);
         if (debug) {
             std::cerr << pretty_print(result) << std::endl;
         }
-        return result.to_string();
+        return result;
+    }
+
+    /**
+     * Evaluate a JMESPath expression against the JSON document without copying the result.
+     * The result refers into doc, the parameters and the expression, so the expression must
+     * outlive it. Replacing doc or a parameter turns the result into a copy first.
+     * @param expr JMESPath expression
+     * @return Result of the evaluation as a handle
+     */
+    std::unique_ptr<BorrowedResult> eval_expr_ref(const jmespath_expr_type &expr) const {
+        ParallelProjections::Scope scope;
+        auto result = expr.evaluate_ref(doc, params_);
+        if (debug) {
+            std::cerr << pretty_print(result.value()) << std::endl;
+        }
+        return std::make_unique<BorrowedResult>(std::move(result), std::vector<const void *>{&doc, &params_});
+    }
+
+    /**
+     * Replace the JSON document.
+     * @param value New document
+     */
+    void set_doc(json value) {
+        BorrowedResult::release(&doc);
+        doc = std::move(value);
+    }
+
+    /**
+     * Add parameters for JMESPath evaluation.
+     * @param key Parameter key
+     * @param value Parameter value as JSON string
+     */
+    void add_params(const std::string &key, const std::string &value) {
+        auto param = json::parse(value);
+        auto it = params_.find(key);
+        if (it == params_.end()) {
+            params_.emplace(key, std::move(param));
+            return;
+        }
+        BorrowedResult::release(&params_);
+        it->second = std::move(param);
+    }
+
+    json doc;
+    bool debug = false;
+    private:
+    std::map<std::string, json> params_;
+};
+
+/**
+ * A typed column buffer holding the results of one transform in columnar output mode.
+ * Scalars of a single type are stored contiguously (strings as offsets into one UTF-8 buffer)
+ * together with a validity bitmap marking non-null cells. A column that receives values of
+ * mixed or non-scalar types falls back to storing json cells.
+ */
+struct Column {
+    enum class Kind { empty, int64, float64, boolean, string, json };
+
+    Kind kind() const { return kind_; }
+    size_t size() const { return size_; }
+    const std::vector<int64_t> &ints() const { return ints_; }
+    const std::vector<double> &doubles() const { return doubles_; }
+    const std::vector<uint8_t> &bools() const { return bools_; }
+    const std::vector<int64_t> &offsets() const { return offsets_; }
+    const std::string &chars() const { return chars_; }
+    /**
+     * Bitmap with bit i (least significant bit first) set if cell i is not null.
+     */
+    const std::vector<uint8_t> &validity() const { return validity_; }
+
+    bool is_valid(size_t i) const {
+        return (validity_[i / 8] >> (i % 8)) & 1;
+    }
+
+    /**
+     * Append a cell, switching the column to json cells if its type does not fit.
+     * @param value Cell value
+     */
+    void push_back(const json &value) {
+        if (value.is_null()) {
+            __push_default();
+            __set_valid(false);
+            return;
+        }
+        Kind k = kind_of(value);
+        if (kind_ == Kind::empty) {
+            kind_ = k;
+            size_t n = size_;
+            size_ = 0;
+            validity_.clear();
+            for (size_t i = 0; i < n; ++i) {
+                __push_default();
+                __set_valid(false);
+            }
+        } else if (kind_ != k && kind_ != Kind::json) {
+            __to_json();
+        }
+        switch (kind_) {
+        case Kind::int64:
+            ints_.push_back(value.as<int64_t>());
+            break;
+        case Kind::float64:
+            doubles_.push_back(value.as_double());
+            break;
+        case Kind::boolean:
+            bools_.push_back(value.as_bool());
+            break;
+        case Kind::string: {
+            auto sv = value.as_string_view();
+            chars_.append(sv.data(), sv.size());
+            offsets_.push_back(static_cast<int64_t>(chars_.size()));
+            break;
+        }
+        default:
+            cells_.push_back(value);
+            break;
+        }
+        __set_valid(true);
+    }
+
+    /**
+     * Get a cell as a json value.
+     * @param i Cell index
+     */
+    json at(size_t i) const {
+        if (!is_valid(i)) {
+            return json::null();
+        }
+        switch (kind_) {
+        case Kind::int64:
+            return json(ints_[i]);
+        case Kind::float64:
+            return json(doubles_[i]);
+        case Kind::boolean:
+            return json(bools_[i] != 0);
+        case Kind::string:
+            return json(__string_at(i));
+        case Kind::json:
+            return cells_[i];
+        default:
+            return json::null();
+        }
+    }
+
+    /**
+     * Write a cell to a visitor (e.g. a MessagePack encoder).
+     * @param i Cell index
+     * @param visitor Visitor receiving the cell
+     */
+    void dump(size_t i, jsoncons::json_visitor &visitor) const {
+        if (!is_valid(i)) {
+            visitor.null_value();
+            return;
+        }
+        switch (kind_) {
+        case Kind::int64:
+            visitor.int64_value(ints_[i]);
+            break;
+        case Kind::float64:
+            visitor.double_value(doubles_[i]);
+            break;
+        case Kind::boolean:
+            visitor.bool_value(bools_[i] != 0);
+            break;
+        case Kind::string:
+            visitor.string_value(__string_at(i));
+            break;
+        default:
+            cells_[i].dump(visitor);
+            break;
+        }
+    }
+
+    /**
+     * Drop the first n cells.
+     * @param n Number of cells to drop
+     */
+    void erase_front(size_t n) {
+        n = std::min(n, size_);
+        if (n == 0) {
+            return;
+        }
+        switch (kind_) {
+        case Kind::int64:
+            ints_.erase(ints_.begin(), ints_.begin() + n);
+            break;
+        case Kind::float64:
+            doubles_.erase(doubles_.begin(), doubles_.begin() + n);
+            break;
+        case Kind::boolean:
+            bools_.erase(bools_.begin(), bools_.begin() + n);
+            break;
+        case Kind::string: {
+            int64_t base = offsets_[n];
+            chars_.erase(0, static_cast<size_t>(base));
+            offsets_.erase(offsets_.begin(), offsets_.begin() + n);
+            for (auto &offset: offsets_) {
+                offset -= base;
+            }
+            break;
+        }
+        case Kind::json:
+            cells_.erase(cells_.begin(), cells_.begin() + n);
+            break;
+        default:
+            break;
+        }
+        std::vector<uint8_t> validity((size_ - n + 7) / 8, 0);
+        for (size_t i = n; i < size_; ++i) {
+            if (is_valid(i)) {
+                validity[(i - n) / 8] |= uint8_t(1) << ((i - n) % 8);
+            }
+        }
+        validity_.swap(validity);
+        size_ -= n;
+    }
+
+    void clear() {
+        *this = Column();
+    }
+
+    /**
+     * Name of the column kind, as exposed to Python.
+     */
+    std::string kind_name() const {
+        switch (kind_) {
+        case Kind::int64:
+            return "int64";
+        case Kind::float64:
+            return "float64";
+        case Kind::boolean:
+            return "bool";
+        case Kind::string:
+            return "string";
+        case Kind::json:
+            return "json";
+        default:
+            return "empty";
+        }
+    }
+
+    /**
+     * The column kind able to store a non-null value without losing information.
+     * @param value Cell value
+     */
+    static Kind kind_of(const json &value) {
+        if (value.tag() != jsoncons::semantic_tag::none) {
+            return Kind::json;
+        }
+        switch (value.type()) {
+        case jsoncons::json_type::int64:
+            return Kind::int64;
+        case jsoncons::json_type::uint64:
+            return value.as<uint64_t>() <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) ? Kind::int64 : Kind::json;
+        case jsoncons::json_type::float64:
+            return Kind::float64;
+        case jsoncons::json_type::boolean:
+            return Kind::boolean;
+        case jsoncons::json_type::string:
+            return Kind::string;
+        default:
+            return Kind::json;
+        }
+    }
+
+private:
+    Kind kind_ = Kind::empty;
+    size_t size_ = 0;
+    std::vector<int64_t> ints_;
+    std::vector<double> doubles_;
+    std::vector<uint8_t> bools_;
+    std::vector<int64_t> offsets_{0};
+    std::string chars_;
+    std::vector<json> cells_;
+    std::vector<uint8_t> validity_;
+
+    std::string_view __string_at(size_t i) const {
+        return std::string_view(chars_.data() + offsets_[i], static_cast<size_t>(offsets_[i + 1] - offsets_[i]));
+    }
+
+    void __push_default() {
+        switch (kind_) {
+        case Kind::int64:
+            ints_.push_back(0);
+            break;
+        case Kind::float64:
+            doubles_.push_back(0.0);
+            break;
+        case Kind::boolean:
+            bools_.push_back(0);
+            break;
+        case Kind::string:
+            offsets_.push_back(offsets_.back());
+            break;
+        case Kind::json:
+            cells_.push_back(json::null());
+            break;
+        default:
+            break;
+        }
+    }
+
+    void __set_valid(bool valid) {
+        if (size_ % 8 == 0) {
+            validity_.push_back(0);
+        }
+        if (valid) {
+            validity_.back() |= uint8_t(1) << (size_ % 8);
+        }
+        ++size_;
+    }
+
+    void __to_json() {
+        std::vector<json> cells;
+        cells.reserve(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            cells.push_back(at(i));
+        }
+        ints_.clear();
+        doubles_.clear();
+        bools_.clear();
+        offsets_.assign(1, 0);
+        chars_.clear();
+        cells_.swap(cells);
+        kind_ = Kind::json;
+    }
+};
+
+/**
+ * A prefix tree of the chains of field names that a set of expressions start with, so that
+ * e.g. "a.b.c == `1`" and "a.b.d" look up a and b once per document. Node 0 is the document
+ * itself and every node comes after its parent.
+ */
+struct SharedPaths {
+    using expr_type = jmespath::jmespath_expression<json>;
+
+    /**
+     * Values of the nodes in one document, each looked up the first time it is needed.
+     */
+    struct Values {
+        Values(const SharedPaths &paths, const json &doc): paths_(paths), values_(paths.nodes_.size(), nullptr) {
+            values_[0] = &doc;
+        }
+
+        const json &doc() const { return *values_[0]; }
+
+        const json &operator[](size_t node) {
+            if (!values_[node]) {
+                static const json null_value = json::null();
+                auto &n = paths_.nodes_[node];
+                const json *member = (*this)[n.parent].find_value(n.name);
+                values_[node] = member ? member : &null_value;
+            }
+            return *values_[node];
+        }
+
+    private:
+        const SharedPaths &paths_;
+        std::vector<const json *> values_;
+    };
+
+    /**
+     * Drop all chains.
+     */
+    void clear() {
+        nodes_.assign(1, Node());
+    }
+
+    /**
+     * Add the leading chain of an expression.
+     * @param expr Compiled expression
+     * @return Node of the whole chain, 0 if the expression does not start with one
+     */
+    size_t add(const expr_type &expr) {
+        size_t node = 0;
+        for (auto &name: expr.leading_path()) {
+            node = __child(node, name);
+        }
+        return node;
+    }
+
+    /**
+     * Evaluate an expression from the value of the node returned when adding it.
+     * @param expr Compiled expression
+     * @param node Node of its leading chain
+     * @param values Node values of the document
+     * @param params Parameter values in slot order of the schema of expr
+     * @return Result of the expression
+     */
+    json evaluate(const expr_type &expr, size_t node, Values &values, const std::vector<json> &params) const {
+        return expr.evaluate_from(values.doc(), nodes_[node].depth, values[node], params);
+    }
+
+private:
+    struct Node {
+        size_t parent = 0;
+        size_t depth = 0;
+        std::string name;
+    };
+    std::vector<Node> nodes_ = std::vector<Node>(1);
+
+    size_t __child(size_t parent, const std::string &name) {
+        for (size_t i = parent + 1; i < nodes_.size(); ++i) {
+            if (nodes_[i].parent == parent && nodes_[i].name == name) {
+                return i;
+            }
+        }
+        nodes_.push_back(Node{parent, nodes_[parent].depth + 1, name});
+        return nodes_.size() - 1;
+    }
+};
+
+/**
+ * A class for filtering and transforming JSON data using JMESPath expressions.
+ */
+struct JsonQuery {
+    /**
+     * Claims the query for a batch processed with the GIL released. Until the scope ends, every
+     * other call on the query raises instead of racing with the batch, including another batch.
+     * Created and destroyed with the GIL held, so that the flag needs no further synchronization.
+     */
+    struct BatchScope {
+        explicit BatchScope(JsonQuery &query): query_(query) {
+            query_.__check_idle();
+            query_.busy_ = true;
+        }
+        ~BatchScope() {
+            query_.busy_ = false;
+        }
+        BatchScope(const BatchScope &) = delete;
+        BatchScope &operator=(const BatchScope &) = delete;
+
+    private:
+        JsonQuery &query_;
+    };
+
+    /**
+     * Constructor for JsonQuery.
+     */
+    JsonQuery() {}
+
+    /**
+     * Set up the predicate expression used for filtering.
+     * @param predicate JMESPath predicate expression
+     */
+    void setup_predicate(const std::string &predicate) {
+        __check_idle();
+        predicate_expr_ = ExpressionCache::instance().get(predicate, param_schema_);
+        predicate_ = predicate;
+        // predicates that only read fields by name are evaluated on a document holding just those fields
+        predicate_projection_ = __make_projection({predicate_expr_.get()});
+        __share_paths();
+    }
+
+    /**
+     * Set up transform expressions used for data transformation.
+     * @param transforms List of JMESPath transform expressions
+     */
+    void setup_transforms(const std::vector<std::string> &transforms) {
+        __check_idle();
+        if (columnar_ && size() > 0 && columns_.size() != transforms.size()) {
+            throw std::runtime_error("Cannot change the number of transforms while columnar data is pending");
+        }
+        transforms_expr_.clear();
+        transforms_expr_.reserve(transforms.size());
+        for (auto &t: transforms) {
+            transforms_expr_.push_back(ExpressionCache::instance().get(t, param_schema_));
+        }
+        transforms_ = transforms;
+        std::vector<const jmespath::jmespath_expression<json> *> exprs;
+        for (auto &expr: transforms_expr_) {
+            exprs.push_back(expr.get());
+        }
+        transforms_projection_ = exprs.empty() ? nullptr : __make_projection(exprs);
+        if (columnar_ && columns_.size() != transforms.size()) {
+            __reset_columns(transforms.size());
+        }
+        __share_paths();
+    }
+
+    /**
+     * Switch between row-major and columnar output. Clears all processed data.
+     * In columnar mode each transform gets a typed column buffer instead of one json per cell.
+     * @param columnar Whether to store results as columns
+     */
+    void set_columnar(bool columnar) {
+        __check_idle();
+        clear();
+        columnar_ = columnar;
+        __reset_columns(columnar ? transforms_.size() : 0);
+    }
+
+    /**
+     * Check whether results are stored as columns.
+     * @return True in columnar mode, false otherwise
+     */
+    bool columnar() const {
+        __check_idle();
+        return columnar_;
+    }
+
+    /**
+     * Get the column buffer of a transform in columnar mode.
+     * The column is shared with the caller and never modified by the query afterwards:
+     * processing, exporting or clearing rows first replaces it with a copy or a new column.
+     * @param index Transform index
+     * @return Column holding the results of the transform
+     */
+    std::shared_ptr<const Column> column(size_t index) const {
+        __check_idle();
+        if (!columnar_) {
+            throw std::runtime_error("Columns are only available in columnar mode");
+        }
+        if (index >= columns_.size()) {
+            throw std::out_of_range("Column index out of range");
+        }
+        return columns_[index];
+    }
+
+    /**
+     * Get the number of processed rows.
+     * @return Number of rows
+     */
+    size_t size() const {
+        __check_idle();
+        if (columnar_) {
+            return columns_.empty() ? 0 : columns_.front()->size();
+        }
+        return outputs_.size();
+    }
+
+    /**
+     * Add parameters for JMESPath evaluation.
+     * Expressions are compiled against the declared parameters, so that $key resolves to a slot
+     * of the parameter values instead of being looked up by name for every document.
+     * @param key Parameter key
+     * @param value Parameter value as JSON string
+     */
+    void add_params(const std::string &key, const std::string &value) {
+        __check_idle();
+        auto param = json::parse(value);
+        size_t slot = param_schema_.find(key);
+        if (slot < param_values_.size()) {
+            param_values_[slot] = std::move(param);
+            return;
+        }
+        param_schema_.add(key);
+        param_values_.push_back(std::move(param));
+        // expressions compiled before the parameter was declared would not find it
+        if (predicate_expr_) {
+            setup_predicate(predicate_);
+        }
+        if (!transforms_expr_.empty()) {
+            setup_transforms(transforms_);
+        }
+    }
+
+    /**
+     * Check if a MessagePack message matches the predicate.
+     * @param msg MessagePack data
+     * @return True if the message matches, false otherwise
+     */
+    bool matches(std::string_view msg) const {
+        __check_idle();
+        if (!predicate_expr_) {
+            return false;
+        }
+        return __matches_msgpack(msg);
+    }
+
+    /**
+     * Check if a JSON document matches the predicate.
+     * @param doc JSON document
+     * @return True if the document matches, false otherwise
+     */
+    bool matches_json(const json &doc) const {
+        __check_idle();
+        if (!predicate_expr_) {
+            return false;
+        }
+        return __matches(doc);
+    }
+
+    /**
+     * Process a MessagePack message with predicate matching and transformation.
+     * @param msg MessagePack data
+     * @param skip_predicate Whether to skip predicate matching
+     * @param raise_error Whether to raise errors during transformation
+     * @return True if processing succeeded, false otherwise
+     */
+    bool process(std::string_view msg, bool skip_predicate = false, bool raise_error = false) {
+        __check_idle();
+        std::vector<json> row;
+        if (!__transform_msgpack(msg, skip_predicate, raise_error, row)) {
+            return false;
+        }
+        __append_row(std::move(row));
+        return true;
+    }
+
+    /**
+     * Process a batch of MessagePack messages with predicate matching and transformation.
+     * Does not touch any Python object, so bindings may release the GIL around it.
+     * With more than one thread, messages are split into chunks evaluated by a worker pool
+     * into per-thread row buffers, which are merged into the outputs once the batch is done.
+     * If any message fails, no row of the batch is kept.
+     * Callers releasing the GIL must hold a BatchScope on the query for the whole call.
+     * @param msgs MessagePack messages
+     * @param skip_predicate Whether to skip predicate matching
+     * @param raise_error Whether to raise errors during transformation
+     * @param num_threads Number of worker threads, 0 to use all hardware threads
+     * @param keep_order Whether rows keep the input order when using multiple threads
+     * @return Number of messages that matched and were processed
+     */
+    size_t process_batch(const std::vector<std::string_view> &msgs, bool skip_predicate = false, bool raise_error = false,
+                         int num_threads = 1, bool keep_order = true) {
+        if (num_threads <= 0) {
+            num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+        const size_t chunk_size = 64;
+        const size_t num_chunks = (msgs.size() + chunk_size - 1) / chunk_size;
+        if (num_threads == 1 || num_chunks < 2) {
+            // rows are only stored once every message went through, as in the threaded path
+            std::deque<std::vector<json>> rows;
+            std::vector<json> row;
+            for (auto &msg: msgs) {
+                if (__transform_msgpack(msg, skip_predicate, raise_error, row)) {
+                    rows.emplace_back(std::move(row));
+                    row.clear();
+                }
+            }
+            for (auto &r: rows) {
+                __append_row(std::move(r));
+            }
+            return rows.size();
+        }
+        num_threads = static_cast<int>(std::min<size_t>(num_threads, num_chunks));
+
+        // With keep_order, every chunk gets its own buffer so they can be merged in input order;
+        // otherwise each thread appends to its own shard.
+        std::vector<std::deque<std::vector<json>>> shards(keep_order ? num_chunks : num_threads);
+        std::atomic<size_t> next_chunk{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto worker = [&](int thread_index) {
+            try {
+                std::vector<json> row;
+                while (!failed) {
+                    size_t chunk = next_chunk++;
+                    if (chunk >= num_chunks) {
+                        break;
+                    }
+                    auto &shard = shards[keep_order ? chunk : thread_index];
+                    size_t end = std::min(msgs.size(), (chunk + 1) * chunk_size);
+                    for (size_t i = chunk * chunk_size; i < end; ++i) {
+                        if (__transform_msgpack(msgs[i], skip_predicate, raise_error, row)) {
+                            shard.emplace_back(std::move(row));
+                            row.clear();
+                        }
+                    }
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads - 1);
+        for (int t = 1; t < num_threads; ++t) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        size_t matched = 0;
+        for (auto &shard: shards) {
+            matched += shard.size();
+            for (auto &row: shard) {
+                __append_row(std::move(row));
+            }
+        }
+        return matched;
+    }
+
+    /**
+     * Process a buffer of length-prefixed MessagePack messages.
+     * Each message is preceded by its size as a 4-byte big-endian unsigned integer.
+     * @param buffer Concatenated length-prefixed MessagePack messages
+     * @param skip_predicate Whether to skip predicate matching
+     * @param raise_error Whether to raise errors during transformation
+     * @param num_threads Number of worker threads, 0 to use all hardware threads
+     * @param keep_order Whether rows keep the input order when using multiple threads
+     * @return Number of messages that matched and were processed
+     */
+    size_t process_packed(std::string_view buffer, bool skip_predicate = false, bool raise_error = false,
+                          int num_threads = 1, bool keep_order = true) {
+        return process_batch(split_packed(buffer), skip_predicate, raise_error, num_threads, keep_order);
+    }
+
+    /**
+     * Process a JSON document with predicate matching and transformation.
+     * @param doc JSON document
+     * @param skip_predicate Whether to skip predicate matching
+     * @param raise_error Whether to raise errors during transformation
+     * @return True if processing succeeded, false otherwise
+     */
+    bool process_json(const json &doc, bool skip_predicate = false, bool raise_error = false) {
+        __check_idle();
+        std::vector<json> row;
+        if (!__transform(doc, skip_predicate, raise_error, row)) {
+            return false;
+        }
+        __append_row(std::move(row));
+        return true;
+    }
+
+    /**
+     * Export the processed data as JSON.
+     * @return JSON array of processed data
+     */
+    json export_json() const {
+        __check_idle();
+        json result = json::make_array();
+        result.reserve(size());
+        if (columnar_) {
+            for (size_t i = 0; i < size(); ++i) {
+                json json_row = json::make_array();
+                json_row.reserve(columns_.size());
+                for (const auto& column : columns_) {
+                    json_row.push_back(column->at(i));
+                }
+                result.push_back(json_row);
+            }
+            return result;
+        }
+        for (const auto& row : outputs_) {
+            json json_row = json::make_array();
+            json_row.reserve(row.size());
+            for (const auto& cell : row) {
+                json_row.push_back(cell);
+            }
+            result.push_back(json_row);
+        }
+        return result;
+    }
+
+    /**
+     * Export the processed data as MessagePack.
+     * @return Binary data containing the MessagePack representation
+     */
+    std::vector<uint8_t> export_() const {
+        __check_idle();
+        std::vector<uint8_t> output;
+        __export_rows(0, size(), output);
+        return output;
+    }
+
+    /**
+     * Export up to max_rows of the oldest processed rows as MessagePack and drop them.
+     * @param max_rows Maximum number of rows to export
+     * @return Binary data containing the MessagePack representation of the exported rows
+     */
+    std::vector<uint8_t> export_chunk(size_t max_rows) {
+        __check_idle();
+        size_t n = std::min(max_rows, size());
+        std::vector<uint8_t> output;
+        __export_rows(0, n, output);
+        if (columnar_) {
+            for (size_t j = 0; j < columns_.size(); ++j) {
+                __own_column(j).erase_front(n);
+            }
+        } else {
+            outputs_.erase(outputs_.begin(), outputs_.begin() + n);
+        }
+        return output;
     }
 
     /**
-     * Evaluate a JMESPath expression against the JSON document.
-     * @param expr JMESPath expression
-     * @return Result of the evaluation as a json object
+     * Export the processed data as a MessagePack map from each transform expression
+     * to the array of its results.
+     * @return Binary data containing the MessagePack representation
      */
-    json eval_expr(const jmespath_expr_type &expr) const {
-        auto result = expr.evaluate(doc, params_);
-        if (debug) {
-            std::cerr << pretty_print(result) << std::endl;
+    std::vector<uint8_t> export_columns() const {
+        __check_idle();
+        std::vector<uint8_t> output;
+        msgpack::msgpack_bytes_encoder encoder(output);
+        encoder.begin_object(transforms_.size());
+        for (size_t j = 0; j < transforms_.size(); ++j) {
+            encoder.key(transforms_[j]);
+            encoder.begin_array(size());
+            for (size_t i = 0; i < size(); ++i) {
+                __dump_cell(i, j, encoder);
+            }
+            encoder.end_array();
         }
-        return result;
+        encoder.end_object();
+        encoder.flush();
+        return output;
     }
 
     /**
-     * Add parameters for JMESPath evaluation.
-     * @param key Parameter key
-     * @param value Parameter value as JSON string
+     * Clear all processed data.
      */
-    void add_params(const std::string &key, const std::string &value) {
-        params_[key] = json::parse(value);
+    void clear() {
+        __check_idle();
+        outputs_.clear();
+        for (auto &column: columns_) {
+            if (column.use_count() > 1) {
+                column = std::make_shared<Column>();
+            } else {
+                column->clear();
+            }
+        }
     }
 
-    json doc;
     bool debug = false;
-    private:
-    std::map<std::string, json> params_;
-};
 
-/**
- * A class for filtering and transforming JSON data using JMESPath expressions.
- */
-struct JsonQuery {
+private:
+    std::string predicate_;
+    std::shared_ptr<const jmespath::jmespath_expression<json>> predicate_expr_;
+    std::unique_ptr<msgpack::msgpack_projection> predicate_projection_;
+    std::vector<std::string> transforms_;
+    std::vector<std::shared_ptr<const jmespath::jmespath_expression<json>>> transforms_expr_;
+    std::unique_ptr<msgpack::msgpack_projection> transforms_projection_;
+    // lookups shared by the predicate and the transforms, see __share_paths
+    SharedPaths shared_paths_;
+    size_t predicate_node_ = 0;
+    std::vector<size_t> transform_nodes_;
+    std::vector<size_t> transform_sources_; // first transform compiled to the same expression
+    jmespath::parameter_schema<json> param_schema_;
+    std::vector<json> param_values_; // in slot order of param_schema_
+
+    std::deque<std::vector<json>> outputs_;
+    bool columnar_ = false;
+    std::vector<std::shared_ptr<Column>> columns_; // shared with Python once handed out by column()
+    bool busy_ = false; // set by BatchScope, only accessed with the GIL held
+
     /**
-     * Constructor for JsonQuery.
+     * Internal method to refuse calls while a batch is being processed on another thread.
      */
-    JsonQuery() {}
+    void __check_idle() const {
+        if (busy_) {
+            throw std::runtime_error("JsonQuery is busy processing a batch in another thread");
+        }
+    }
 
     /**
-     * Set up the predicate expression used for filtering.
-     * @param predicate JMESPath predicate expression
+     * Split a buffer of length-prefixed messages into views of each message.
+     * @param buffer Concatenated messages, each preceded by a 4-byte big-endian size
+     * @return Views into buffer, one per message
      */
-    void setup_predicate(const std::string &predicate) {
-        predicate_expr_ = std::make_unique<jmespath::jmespath_expression<json>>(jmespath::make_expression<json>(predicate));
-        predicate_ = predicate;
+    static std::vector<std::string_view> split_packed(std::string_view buffer) {
+        std::vector<std::string_view> msgs;
+        size_t pos = 0;
+        while (pos < buffer.size()) {
+            if (buffer.size() - pos < 4) {
+                throw std::runtime_error("Truncated length prefix at offset " + std::to_string(pos));
+            }
+            auto p = reinterpret_cast<const uint8_t *>(buffer.data() + pos);
+            size_t len = (size_t(p[0]) << 24) | (size_t(p[1]) << 16) | (size_t(p[2]) << 8) | size_t(p[3]);
+            pos += 4;
+            if (buffer.size() - pos < len) {
+                throw std::runtime_error("Truncated message at offset " + std::to_string(pos));
+            }
+            msgs.push_back(buffer.substr(pos, len));
+            pos += len;
+        }
+        return msgs;
     }
 
     /**
-     * Set up transform expressions used for data transformation.
-     * @param transforms List of JMESPath transform expressions
+     * Internal method to replace the column buffers with count empty ones.
+     * @param count Number of columns
      */
-    void setup_transforms(const std::vector<std::string> &transforms) {
-        transforms_expr_.clear();
-        transforms_expr_.reserve(transforms.size());
-        for (auto &t: transforms) {
-            transforms_expr_.push_back(std::make_unique<jmespath::jmespath_expression<json>>(jmespath::make_expression<json>(t)));
+    void __reset_columns(size_t count) {
+        columns_.clear();
+        columns_.reserve(count);
+        for (size_t j = 0; j < count; ++j) {
+            columns_.push_back(std::make_shared<Column>());
         }
-        transforms_ = transforms;
     }
 
     /**
-     * Add parameters for JMESPath evaluation.
-     * @param key Parameter key
-     * @param value Parameter value as JSON string
+     * Internal method to get a column buffer for modification, copying it first if it was
+     * handed out by column(), so that buffers exported from the shared one stay valid.
+     * @param j Transform index
+     * @return Column owned by the query alone
      */
-    void add_params(const std::string &key, const std::string &value) {
-        params_[key] = json::parse(value);
+    Column &__own_column(size_t j) {
+        auto &column = columns_[j];
+        if (column.use_count() > 1) {
+            column = std::make_shared<Column>(*column);
+        }
+        return *column;
     }
 
     /**
-     * Check if a MessagePack message matches the predicate.
-     * @param msg MessagePack data as string
-     * @return True if the message matches, false otherwise
+     * Internal method to store a processed row, either as is or split into the column buffers.
+     * @param row Row with one cell per transform
      */
-    bool matches(const std::string &msg) const {
-        if (!predicate_expr_) {
-            return false;
+    void __append_row(std::vector<json> &&row) {
+        if (!columnar_) {
+            outputs_.emplace_back(std::move(row));
+            return;
+        }
+        for (size_t j = 0; j < columns_.size(); ++j) {
+            __own_column(j).push_back(row[j]);
         }
-        auto doc = msgpack::decode_msgpack<json>(msg);
-        return __matches(doc);
     }
 
     /**
-     * Check if a JSON document matches the predicate.
-     * @param doc JSON document
-     * @return True if the document matches, false otherwise
+     * Internal method to write one cell to a visitor.
+     * @param i Row index
+     * @param j Transform index
+     * @param visitor Visitor receiving the cell
      */
-    bool matches_json(const json &doc) const {
-        if (!predicate_expr_) {
-            return false;
+    void __dump_cell(size_t i, size_t j, jsoncons::json_visitor &visitor) const {
+        if (columnar_) {
+            columns_[j]->dump(i, visitor);
+        } else {
+            outputs_[i][j].dump(visitor);
         }
-        return __matches(doc);
     }
 
     /**
-     * Process a MessagePack message with predicate matching and transformation.
-     * @param msg MessagePack data as string
-     * @param skip_predicate Whether to skip predicate matching
-     * @param raise_error Whether to raise errors during transformation
-     * @return True if processing succeeded, false otherwise
+     * Internal method to encode rows as a MessagePack array of arrays,
+     * writing each cell straight into the encoder.
+     * @param first Index of the first row
+     * @param last Index past the last row
+     * @param output Buffer receiving the MessagePack data
      */
-    bool process(const std::string &msg, bool skip_predicate = false, bool raise_error = false) {
-        auto doc = msgpack::decode_msgpack<json>(msg);
-        return process_json(doc, skip_predicate, raise_error);
+    void __export_rows(size_t first, size_t last, std::vector<uint8_t> &output) const {
+        msgpack::msgpack_bytes_encoder encoder(output);
+        encoder.begin_array(last - first);
+        for (size_t i = first; i < last; ++i) {
+            size_t width = columnar_ ? columns_.size() : outputs_[i].size();
+            encoder.begin_array(width);
+            for (size_t j = 0; j < width; ++j) {
+                __dump_cell(i, j, encoder);
+            }
+            encoder.end_array();
+        }
+        encoder.end_array();
+        encoder.flush();
     }
 
     /**
-     * Process a JSON document with predicate matching and transformation.
+     * Internal method to match a JSON document and evaluate the transforms into a row.
+     * Only reads the query state, so it is safe to call from several threads at once.
      * @param doc JSON document
      * @param skip_predicate Whether to skip predicate matching
      * @param raise_error Whether to raise errors during transformation
-     * @return True if processing succeeded, false otherwise
+     * @param row Output row, filled with one cell per transform
+     * @return True if the document matched, false otherwise
      */
-    bool process_json(const json &doc, bool skip_predicate = false, bool raise_error = false) {
+    bool __transform(const json &doc, bool skip_predicate, bool raise_error, std::vector<json> &row) const {
         if (!predicate_expr_) {
             skip_predicate = true;
         }
-        if (!skip_predicate && !__matches(doc)) {
+        SharedPaths::Values values(shared_paths_, doc);
+        if (!skip_predicate && !__matches(values)) {
             return false;
         }
         if (transforms_expr_.empty()) {
             throw std::runtime_error("No transform expressions set");
         }
-        std::vector<json> row;
         row.reserve(transforms_expr_.size());
-        for (auto &expr: transforms_expr_) {
+        for (size_t i = 0; i < transforms_expr_.size(); ++i) {
+            if (transform_sources_[i] != i) {
+                row.push_back(row[transform_sources_[i]]);
+                continue;
+            }
             try {
-                row.push_back(expr->evaluate(doc, params_));
+                row.push_back(shared_paths_.evaluate(*transforms_expr_[i], transform_nodes_[i], values, param_values_));
             } catch (const std::exception &e) {
                 if (raise_error) {
                     throw e;
@@ -360,55 +1514,85 @@ struct JsonQuery {
                 row.push_back(json::null());
             }
         }
-        outputs_.emplace_back(std::move(row));
         return true;
     }
 
     /**
-     * Export the processed data as JSON.
-     * @return JSON array of processed data
+     * Internal method to plan the evaluation of the predicate and the transforms together.
+     * The chains of field names they start with are merged into one prefix tree, so that each
+     * document looks up a shared prefix once, and transforms that compile to the same
+     * expression are evaluated once and copied.
      */
-    json export_json() const {
-        json result = json::make_array();
-        result.reserve(outputs_.size());
-        for (const auto& row : outputs_) {
-            json json_row = json::make_array();
-            json_row.reserve(row.size());
-            for (const auto& cell : row) {
-                json_row.push_back(cell);
+    void __share_paths() {
+        shared_paths_.clear();
+        predicate_node_ = predicate_expr_ ? shared_paths_.add(*predicate_expr_) : 0;
+        transform_nodes_.clear();
+        transform_sources_.clear();
+        for (size_t i = 0; i < transforms_expr_.size(); ++i) {
+            transform_nodes_.push_back(shared_paths_.add(*transforms_expr_[i]));
+            size_t source = 0;
+            while (transforms_expr_[source] != transforms_expr_[i]) {
+                ++source;
             }
-            result.push_back(json_row);
+            transform_sources_.push_back(source);
         }
-        return result;
     }
 
     /**
-     * Export the processed data as MessagePack.
-     * @return Binary data containing the MessagePack representation
+     * Internal method to build the projection of the fields read by expressions.
+     * @param exprs Compiled expressions
+     * @return Projection of the fields, or nullptr if an expression may read the whole document
      */
-    std::vector<uint8_t> export_() const {
-        std::vector<uint8_t> output;
-        msgpack::encode_msgpack(export_json(), output);
-        return output;
+    static std::unique_ptr<msgpack::msgpack_projection> __make_projection(const std::vector<const jmespath::jmespath_expression<json> *> &exprs) {
+        std::vector<std::vector<std::string>> paths;
+        for (auto expr: exprs) {
+            if (!expr->root_paths(paths)) {
+                return nullptr;
+            }
+        }
+        auto projection = std::make_unique<msgpack::msgpack_projection>();
+        for (auto &path: paths) {
+            projection->add(path);
+        }
+        return projection;
     }
 
     /**
-     * Clear all processed data.
+     * Internal method to transform a MessagePack message if it matches the predicate.
+     * Expressions that only read fields by name are evaluated on a document decoded with just
+     * those fields, so the predicate rejects a message without decoding the rest of it.
+     * @param msg MessagePack data
+     * @param skip_predicate Whether to skip predicate matching
+     * @param raise_error Whether to raise errors during transformation
+     * @param row Receives the transform results
+     * @return True if the message matched and was transformed, false otherwise
      */
-    void clear() {
-        outputs_.clear();
+    bool __transform_msgpack(std::string_view msg, bool skip_predicate, bool raise_error, std::vector<json> &row) const {
+        bool matched = skip_predicate || !predicate_expr_;
+        if (!matched && predicate_projection_) {
+            if (!__matches_msgpack(msg)) {
+                return false;
+            }
+            matched = true;
+        }
+        // the predicate needs the whole document unless it is already matched
+        auto doc = matched && transforms_projection_ ? msgpack::decode_msgpack<json>(msg, *transforms_projection_)
+                                                     : msgpack::decode_msgpack<json>(msg);
+        return __transform(doc, matched, raise_error, row);
     }
 
-    bool debug = false;
-
-private:
-    std::string predicate_;
-    std::unique_ptr<jmespath::jmespath_expression<json>> predicate_expr_;
-    std::vector<std::string> transforms_;
-    std::vector<std::unique_ptr<jmespath::jmespath_expression<json>>> transforms_expr_;
-    std::map<std::string, json> params_;
-
-    std::deque<std::vector<json>> outputs_;
+    /**
+     * Internal method to check if a MessagePack message matches the predicate,
+     * decoding only the fields it reads when possible.
+     * @param msg MessagePack data
+     * @return True if the message matches the predicate, false otherwise
+     */
+    bool __matches_msgpack(std::string_view msg) const {
+        if (predicate_projection_) {
+            return __matches(msgpack::decode_msgpack<json>(msg, *predicate_projection_));
+        }
+        return __matches(msgpack::decode_msgpack<json>(msg));
+    }
 
     /**
      * Internal method to check if a JSON document matches the predicate.
@@ -416,7 +1600,17 @@ private:
      * @return True if the document matches the predicate, false otherwise
      */
     bool __matches(const json &msg) const {
-        auto ret = predicate_expr_->evaluate(msg, params_);
+        SharedPaths::Values values(shared_paths_, msg);
+        return __matches(values);
+    }
+
+    /**
+     * Internal method to check if a document matches the predicate, sharing lookups with the transforms.
+     * @param values Node values of the document
+     * @return True if the document matches the predicate, false otherwise
+     */
+    bool __matches(SharedPaths::Values &values) const {
+        auto ret = shared_paths_.evaluate(*predicate_expr_, predicate_node_, values, param_values_);
         return /*ret.is_bool() && */ ret.as_bool();
     }
 };
@@ -436,6 +1630,11 @@ PYBIND11_MODULE(_core, m) {
     Functions:
         msgpack_encode: Convert a JSON string to MessagePack binary format.
         msgpack_decode: Convert MessagePack binary data to a JSON string.
+        expression_cache_info: Get the statistics of the compiled expression cache.
+        expression_cache_resize: Set the capacity of the compiled expression cache.
+        expression_cache_clear: Clear the compiled expression cache.
+        set_parallel_projections: Evaluate projections over large arrays and objects on several threads.
+        parallel_projections_info: Get the parallel projection settings.
     )pbdoc";
 
     py::class_<json>(m, "Json", py::module_local(), py::dynamic_attr()) //
@@ -444,7 +1643,9 @@ PYBIND11_MODULE(_core, m) {
     )pbdoc")
     // from/to_python
     .def("from_python", [](json &self, const py::handle &obj) -> json & {
-        self = pyjson::to_json(obj);
+        auto value = pyjson::to_json(obj);
+        BorrowedResult::release(&self);
+        self = std::move(value);
         return self;
     }, "object"_a, rvp::reference_internal, R"pbdoc(
         Convert a Python object to a JSON object.
@@ -487,18 +1688,58 @@ PYBIND11_MODULE(_core, m) {
     )pbdoc")
 
     // from/to_json
-    .def("from_json", [](json &self, const std::string &input) -> json & {
-        self = json::parse(input);
+    .def("from_json", [](json &self, const std::string &input, bool structural_index) -> json & {
+        auto value = json::parse(input, jsoncons::json_options().structural_index(structural_index));
+        BorrowedResult::release(&self);
+        self = std::move(value);
         return self;
-    }, "json_string"_a, rvp::reference_internal, R"pbdoc(
+    }, "json_string"_a, py::kw_only(), "structural_index"_a = false, rvp::reference_internal, R"pbdoc(
         Parse JSON from a string.
 
         Args:
-            json_string: JSON string to parse
+            json_string: JSON string or UTF-8 bytes to parse
+            structural_index: Parse with the two-stage parser, which first indexes the structural
+                characters of the whole text 64 bytes at a time. Results and errors are the same
+                (default: False)
 
         Returns:
             Json: Reference to self
     )pbdoc")
+    .def_static("from_json_in_situ", [](std::string_view input) {
+        // parse_in_situ writes into the text and long string values keep pointing at it, so parse a
+        // private copy and tie its lifetime to the new Json. Copies of those values own their strings.
+        auto buffer = py::reinterpret_steal<py::bytes>(PyBytes_FromStringAndSize(nullptr, static_cast<Py_ssize_t>(input.size())));
+        if (!buffer) {
+            throw py::error_already_set();
+        }
+        char *data = PyBytes_AS_STRING(buffer.ptr());
+        std::memcpy(data, input.data(), input.size());
+        json value;
+        try {
+            value = json::parse_in_situ(data, input.size());
+        } catch (const jsoncons::ser_error &) {
+            // the buffer is partly decoded by now, parse the text again to report the error as from_json does
+            value = json::parse(jsoncons::string_view(input.data(), input.size()));
+        }
+        py::object result = py::cast(std::move(value));
+        // the callback holds the buffer until result is collected, then drops the weak reference
+        py::cpp_function release_buffer([buffer](py::handle weakref) { weakref.dec_ref(); });
+        (void)py::weakref(result, release_buffer).release();
+        return result;
+    }, "json_string"_a, R"pbdoc(
+        Parse JSON from a string into a new Json, in place.
+
+        The text is copied once into a buffer owned by the returned Json. Escapes are decoded in
+        that buffer and long string values refer to it instead of being allocated one by one.
+        Copies of the values, such as a Json assigned to JsonQueryRepl.doc or the results of
+        JMESPathExpr.evaluate, own their strings. Results and errors are the same as from_json.
+
+        Args:
+            json_string: JSON string or UTF-8 bytes to parse
+
+        Returns:
+            Json: A new Json object
+    )pbdoc")
     .def("to_json", [](const json &self) {
         return self.to_string();
     }, R"pbdoc(
@@ -508,14 +1749,17 @@ PYBIND11_MODULE(_core, m) {
             str: JSON string representation
     )pbdoc")
     // from/to_msgpack
-    .def("from_msgpack", [](json &self, const std::string &input) -> json & {
-        self = msgpack::decode_msgpack<json>(input);
+    .def("from_msgpack", [](json &self, const py::buffer &input) -> json & {
+        auto info = input.request();
+        auto value = msgpack::decode_msgpack<json>(pyjson::to_bytes_view(info));
+        BorrowedResult::release(&self);
+        self = std::move(value);
         return self;
     }, "msgpack_bytes"_a, rvp::reference_internal, R"pbdoc(
         Parse MessagePack binary data into a JSON object.
 
         Args:
-            msgpack_bytes: MessagePack binary data
+            msgpack_bytes: MessagePack binary data as any bytes-like object
 
         Returns:
             Json: Reference to self
@@ -533,6 +1777,43 @@ PYBIND11_MODULE(_core, m) {
     //
     ;
 
+    py::class_<BorrowedResult>(m, "JMESPathResult", py::module_local()) //
+        .def("to_python", [](const BorrowedResult &self) -> py::handle {
+            py::object obj = pyjson::from_json(self.value());
+            return obj.release();
+        }, R"pbdoc(
+            Convert the result to a Python object.
+
+            Returns:
+                object: Python object representation of the result
+        )pbdoc")
+        .def("to_json", [](const BorrowedResult &self) {
+            return self.value().to_string();
+        }, R"pbdoc(
+            Convert the result to a JSON string.
+
+            Returns:
+                str: JSON string representation
+        )pbdoc")
+        .def("to_msgpack", [](const BorrowedResult &self) {
+            std::vector<uint8_t> output;
+            msgpack::encode_msgpack(self.value(), output);
+            return py::bytes(reinterpret_cast<const char *>(output.data()), output.size());
+        }, R"pbdoc(
+            Convert the result to MessagePack binary data.
+
+            Returns:
+                bytes: MessagePack binary data
+        )pbdoc")
+        .def("copy", &BorrowedResult::copy, R"pbdoc(
+            Copy the result into an independent Json object.
+
+            Returns:
+                Json: Copy of the result
+        )pbdoc")
+        //
+        ;
+
     py::class_<JsonQueryRepl>(m, "JsonQueryRepl", py::module_local(), py::dynamic_attr()) //
         .def(py::init<>())
         .def(py::init<const std::string &, bool>(), "json"_a, "debug"_a = false, R"pbdoc(
@@ -560,6 +1841,18 @@ PYBIND11_MODULE(_core, m) {
             Returns:
                 json: Result of the evaluation as a json object
         )pbdoc")
+        .def("eval_expr_ref", &JsonQueryRepl::eval_expr_ref, "expr"_a, py::keep_alive<0, 1>(), py::keep_alive<0, 2>(), R"pbdoc(
+            Evaluate a JMESPath expression against the JSON document without copying the result.
+
+            The result refers into doc and the parameters. If either is modified or replaced
+            afterwards, the result is turned into a copy of its value beforehand.
+
+            Args:
+                expr: JMESPath expression
+
+            Returns:
+                JMESPathResult: Result of the evaluation
+        )pbdoc")
         .def("add_params", &JsonQueryRepl::add_params, "key"_a, "value"_a, R"pbdoc(
             Add parameters for JMESPath evaluation.
 
@@ -567,7 +1860,7 @@ PYBIND11_MODULE(_core, m) {
                 key: Parameter key
                 value: Parameter value as JSON string
         )pbdoc")
-        .def_readwrite("doc", &JsonQueryRepl::doc, R"pbdoc(
+        .def_property("doc", [](JsonQueryRepl &self) -> json & { return self.doc; }, &JsonQueryRepl::set_doc, R"pbdoc(
             The JSON document being queried. This is the data that JMESPath expressions will be evaluated against.
         )pbdoc")
         .def_readwrite("debug", &JsonQueryRepl::debug, R"pbdoc(
@@ -576,6 +1869,78 @@ PYBIND11_MODULE(_core, m) {
         //
         ;
 
+    py::class_<Column, std::shared_ptr<Column>>(m, "Column", py::module_local(), py::buffer_protocol()) //
+        .def_buffer([](const Column &self) -> py::buffer_info {
+            static const uint8_t empty = 0;
+            const void *data = nullptr;
+            size_t count = 0;
+            size_t itemsize = 0;
+            std::string format;
+            switch (self.kind()) {
+            case Column::Kind::int64:
+                data = self.ints().data(), count = self.ints().size();
+                itemsize = sizeof(int64_t), format = py::format_descriptor<int64_t>::format();
+                break;
+            case Column::Kind::float64:
+                data = self.doubles().data(), count = self.doubles().size();
+                itemsize = sizeof(double), format = py::format_descriptor<double>::format();
+                break;
+            case Column::Kind::boolean:
+                data = self.bools().data(), count = self.bools().size();
+                itemsize = sizeof(bool), format = "?";
+                break;
+            case Column::Kind::string:
+                data = self.chars().data(), count = self.chars().size();
+                itemsize = sizeof(uint8_t), format = py::format_descriptor<uint8_t>::format();
+                break;
+            case Column::Kind::empty:
+                itemsize = sizeof(uint8_t), format = py::format_descriptor<uint8_t>::format();
+                break;
+            default:
+                throw std::runtime_error("Column of json cells does not support the buffer protocol");
+            }
+            if (count == 0) {
+                data = &empty;
+            }
+            return py::buffer_info(const_cast<void *>(data), static_cast<py::ssize_t>(itemsize), format, 1,
+                                   {static_cast<py::ssize_t>(count)}, {static_cast<py::ssize_t>(itemsize)}, true);
+        })
+        .def_property_readonly("kind", &Column::kind_name, R"pbdoc(
+            Storage kind of the column: "empty", "int64", "float64", "bool", "string" or "json".
+        )pbdoc")
+        .def("__len__", &Column::size)
+        .def("validity", [](const Column &self) {
+            return py::bytes(reinterpret_cast<const char *>(self.validity().data()), self.validity().size());
+        }, R"pbdoc(
+            Get the validity bitmap of the column.
+
+            Returns:
+                bytes: Bitmap with bit i (least significant bit first) set if row i is not null
+        )pbdoc")
+        .def("offsets", [](const Column &self) {
+            py::bytes data(reinterpret_cast<const char *>(self.offsets().data()), self.offsets().size() * sizeof(int64_t));
+            return py::memoryview(data).attr("cast")("q");
+        }, R"pbdoc(
+            Get the offsets of a string column, row i spans bytes [offsets[i], offsets[i + 1]) of the buffer.
+
+            Returns:
+                memoryview: int64 view of a copy of the offsets
+        )pbdoc")
+        .def("to_python", [](const Column &self) {
+            py::list result(self.size());
+            for (size_t i = 0; i < self.size(); ++i) {
+                result[i] = pyjson::from_json(self.at(i));
+            }
+            return result;
+        }, R"pbdoc(
+            Convert the column to a Python list.
+
+            Returns:
+                list: Cell values, None for null cells
+        )pbdoc")
+        //
+        ;
+
     py::class_<JsonQuery>(m, "JsonQuery", py::module_local(), py::dynamic_attr()) //
         .def(py::init<>(), R"pbdoc(
             Create a new JsonQuery instance.
@@ -599,11 +1964,14 @@ PYBIND11_MODULE(_core, m) {
                 key: Parameter key
                 value: Parameter value as JSON string
         )pbdoc")
-        .def("matches", &JsonQuery::matches, "msgpack"_a, R"pbdoc(
+        .def("matches", [](const JsonQuery &self, const py::buffer &msgpack) {
+            auto info = msgpack.request();
+            return self.matches(pyjson::to_bytes_view(info));
+        }, "msgpack"_a, R"pbdoc(
             Check if a MessagePack message matches the predicate.
 
             Args:
-                msgpack: MessagePack data as bytes
+                msgpack: MessagePack data as any bytes-like object
 
             Returns:
                 bool: True if the message matches, False otherwise
@@ -617,17 +1985,79 @@ PYBIND11_MODULE(_core, m) {
             Returns:
                 bool: True if the document matches, False otherwise
         )pbdoc")
-        .def("process", &JsonQuery::process, "msgpack"_a, py::kw_only(), "skip_predicate"_a = false, "raise_error"_a = false, R"pbdoc(
+        .def("process", [](JsonQuery &self, const py::buffer &msgpack, bool skip_predicate, bool raise_error) {
+            auto info = msgpack.request();
+            return self.process(pyjson::to_bytes_view(info), skip_predicate, raise_error);
+        }, "msgpack"_a, py::kw_only(), "skip_predicate"_a = false, "raise_error"_a = false, R"pbdoc(
             Process a MessagePack message with predicate matching and transformation.
 
             Args:
-                msgpack: MessagePack data as bytes
+                msgpack: MessagePack data as any bytes-like object
                 skip_predicate: Whether to skip predicate matching (default: False)
                 raise_error: Whether to raise errors during transformation (default: False)
 
             Returns:
                 bool: True if processing succeeded, False otherwise
         )pbdoc")
+        .def("process_batch", [](JsonQuery &self, const std::vector<py::buffer> &msgpacks, bool skip_predicate, bool raise_error,
+                                 int num_threads, bool keep_order) {
+            // busy from the first buffer request, which may run Python code of the buffer's type
+            JsonQuery::BatchScope batch(self);
+            std::vector<py::buffer_info> infos;
+            std::vector<std::string_view> views;
+            infos.reserve(msgpacks.size());
+            views.reserve(msgpacks.size());
+            for (auto &msgpack: msgpacks) {
+                infos.push_back(msgpack.request());
+                views.push_back(pyjson::to_bytes_view(infos.back()));
+            }
+            // buffers are released by ~buffer_info, which needs the GIL again
+            py::gil_scoped_release release;
+            return self.process_batch(views, skip_predicate, raise_error, num_threads, keep_order);
+        }, "msgpacks"_a, py::kw_only(), "skip_predicate"_a = false, "raise_error"_a = false,
+             "num_threads"_a = 1, "keep_order"_a = true, R"pbdoc(
+            Process a batch of MessagePack messages with predicate matching and transformation.
+
+            The GIL is released while the batch is processed. With more than one thread,
+            messages are evaluated concurrently and the rows are merged once the batch is done.
+            Until the batch returns, any other call on this JsonQuery from another Python thread
+            raises RuntimeError.
+
+            Args:
+                msgpacks: List of MessagePack data as bytes-like objects
+                skip_predicate: Whether to skip predicate matching (default: False)
+                raise_error: Whether to raise errors during transformation (default: False)
+                num_threads: Number of worker threads, 0 to use all hardware threads (default: 1)
+                keep_order: Whether rows keep the input order when using multiple threads (default: True)
+
+            Returns:
+                int: Number of messages that matched and were processed
+        )pbdoc")
+        .def("process_batch", [](JsonQuery &self, const py::buffer &buffer, bool skip_predicate, bool raise_error,
+                                 int num_threads, bool keep_order) {
+            JsonQuery::BatchScope batch(self);
+            auto info = buffer.request();
+            auto view = pyjson::to_bytes_view(info);
+            py::gil_scoped_release release;
+            return self.process_packed(view, skip_predicate, raise_error, num_threads, keep_order);
+        }, "buffer"_a, py::kw_only(), "skip_predicate"_a = false, "raise_error"_a = false,
+             "num_threads"_a = 1, "keep_order"_a = true, R"pbdoc(
+            Process a buffer of length-prefixed MessagePack messages with predicate matching and transformation.
+
+            Each message is preceded by its size as a 4-byte big-endian unsigned integer.
+            The GIL is released while the batch is processed. Until the batch returns, any other
+            call on this JsonQuery from another Python thread raises RuntimeError.
+
+            Args:
+                buffer: Concatenated length-prefixed MessagePack data as any bytes-like object
+                skip_predicate: Whether to skip predicate matching (default: False)
+                raise_error: Whether to raise errors during transformation (default: False)
+                num_threads: Number of worker threads, 0 to use all hardware threads (default: 1)
+                keep_order: Whether rows keep the input order when using multiple threads (default: True)
+
+            Returns:
+                int: Number of messages that matched and were processed
+        )pbdoc")
         .def("process_json", &JsonQuery::process_json, "msgpack"_a, py::kw_only(), "skip_predicate"_a = false, "raise_error"_a = false, R"pbdoc(
             Process a JSON document with predicate matching and transformation.
 
@@ -648,12 +2078,57 @@ PYBIND11_MODULE(_core, m) {
             Returns:
                 bytes: MessagePack binary data containing the processed results
         )pbdoc")
+        .def("export_chunk", [](JsonQuery& self, size_t max_rows) {
+            auto output = self.export_chunk(max_rows);
+            return py::bytes(reinterpret_cast<const char *>(output.data()), output.size());
+        }, "max_rows"_a, R"pbdoc(
+            Export up to max_rows of the oldest processed rows as MessagePack and drop them.
+
+            Args:
+                max_rows: Maximum number of rows to export
+
+            Returns:
+                bytes: MessagePack binary data containing the exported rows
+        )pbdoc")
+        .def("export_columns", [](const JsonQuery& self) {
+            auto output = self.export_columns();
+            return py::bytes(reinterpret_cast<const char *>(output.data()), output.size());
+        }, R"pbdoc(
+            Export the processed data as a MessagePack map from each transform expression to its results.
+
+            Returns:
+                bytes: MessagePack binary data containing one array per transform
+        )pbdoc")
+        .def("column", [](const JsonQuery &self, size_t index) {
+            return std::const_pointer_cast<Column>(self.column(index));
+        }, "index"_a, R"pbdoc(
+            Get the column buffer of a transform in columnar mode.
+
+            Numeric and bool columns expose their values through the buffer protocol,
+            string columns expose their UTF-8 bytes together with offsets().
+            The column is a snapshot of the rows processed so far: rows processed, exported
+            or cleared afterwards do not change it, so buffers taken from it stay valid.
+
+            Args:
+                index: Transform index
+
+            Returns:
+                Column: Results of the transform
+        )pbdoc")
+        .def_property("columnar", &JsonQuery::columnar, &JsonQuery::set_columnar, R"pbdoc(
+            Columnar mode flag. When True, results are stored in one typed buffer per transform.
+            Changing it clears all processed data.
+        )pbdoc")
+        .def("__len__", &JsonQuery::size)
         .def("export_json", &JsonQuery::export_json, R"pbdoc(
             Export the processed data as JSON.
 
             Returns:
                 Json: JSON array of processed data
         )pbdoc")
+        .def("clear", &JsonQuery::clear, R"pbdoc(
+            Clear all processed data.
+        )pbdoc")
         .def_readwrite("debug", &JsonQuery::debug, R"pbdoc(
             Debug mode flag.
         )pbdoc")
@@ -675,21 +2150,69 @@ PYBIND11_MODULE(_core, m) {
             bytes: MessagePack binary data
     )pbdoc");
 
-    m.def("msgpack_decode", [](const std::string &input) {
-        auto doc = msgpack::decode_msgpack<json>(input);
+    m.def("msgpack_decode", [](const py::buffer &input) {
+        auto info = input.request();
+        auto doc = msgpack::decode_msgpack<json>(pyjson::to_bytes_view(info));
         return doc.to_string();
     }, "msgpack_bytes"_a, R"pbdoc(
         Convert MessagePack binary data to a JSON string.
 
         Args:
-            msgpack_bytes: MessagePack binary data
+            msgpack_bytes: MessagePack binary data as any bytes-like object
 
         Returns:
             str: JSON string representation
     )pbdoc");
 
-    py::class_<jmespath_expr_type>(m, "JMESPathExpr", py::module_local(), py::dynamic_attr()) //
+    m.def("expression_cache_info", []() {
+        return ExpressionCache::instance().info();
+    }, R"pbdoc(
+        Get the statistics of the compiled JMESPath expression cache, shared by JsonQueryRepl.eval,
+        JsonQuery and JMESPathExpr.build.
+
+        Returns:
+            dict: Hits, misses, number of cached expressions (size) and capacity
+    )pbdoc");
+
+    m.def("expression_cache_resize", [](size_t capacity) {
+        ExpressionCache::instance().resize(capacity);
+    }, "capacity"_a, R"pbdoc(
+        Set the maximum number of cached expressions, evicting the least recently used ones.
+
+        Args:
+            capacity: Maximum number of expressions, 0 disables caching
+    )pbdoc");
+
+    m.def("expression_cache_clear", []() {
+        ExpressionCache::instance().clear();
+    }, R"pbdoc(
+        Drop all cached expressions and reset the statistics.
+    )pbdoc");
+
+    m.def("set_parallel_projections", [](int num_threads, size_t threshold) {
+        ParallelProjections::instance().configure(num_threads, threshold);
+    }, "num_threads"_a, "threshold"_a = 100000, R"pbdoc(
+        Evaluate projections ([*], .*, slices and []) over large arrays and objects on several threads,
+        for JsonQueryRepl and JMESPathExpr evaluations. The elements are split into chunks whose
+        results are concatenated in order, so results do not change. Evaluation is serial by default.
+
+        Args:
+            num_threads: Number of threads, the evaluating one included, 0 to use all hardware threads, 1 for serial evaluation
+            threshold: Minimum number of elements of a projection evaluated in parallel (default: 100000)
+    )pbdoc");
+
+    m.def("parallel_projections_info", []() {
+        return ParallelProjections::instance().info();
+    }, R"pbdoc(
+        Get the parallel projection settings.
+
+        Returns:
+            dict: Number of threads (num_threads, 1 if evaluation is serial) and threshold
+    )pbdoc");
+
+    py::class_<jmespath_expr_type, std::shared_ptr<jmespath_expr_type>>(m, "JMESPathExpr", py::module_local(), py::dynamic_attr()) //
         .def("evaluate", [](const jmespath_expr_type &self, const json &doc) -> json {
+            ParallelProjections::Scope scope;
             return self.evaluate(doc);
         }, "doc"_a, R"pbdoc(
             Evaluate the JMESPath expression against a JSON document.
@@ -700,9 +2223,37 @@ PYBIND11_MODULE(_core, m) {
             Returns:
                 json: Result of the evaluation
         )pbdoc")
+        .def("evaluate_ref", [](const jmespath_expr_type &self, const json &doc) {
+            ParallelProjections::Scope scope;
+            return std::make_unique<BorrowedResult>(self.evaluate_ref(doc), std::vector<const void *>{&doc});
+        }, "doc"_a, py::keep_alive<0, 1>(), py::keep_alive<0, 2>(), R"pbdoc(
+            Evaluate the JMESPath expression against a JSON document without copying the result.
+
+            The result refers into doc. If doc is modified afterwards, the result is turned
+            into a copy of its value beforehand.
+
+            Args:
+                doc: JSON document
+
+            Returns:
+                JMESPathResult: Result of the evaluation
+        )pbdoc")
+        .def("dump", [](const jmespath_expr_type &self) {
+            std::ostringstream os;
+            self.dump(os);
+            return os.str();
+        }, R"pbdoc(
+            Describe the optimized plan of the expression, for debugging.
+
+            Constant subexpressions appear folded into literals. Each line is one step,
+            and the parts of nested expressions are indented further.
+
+            Returns:
+                str: The plan, one step per line
+        )pbdoc")
         //
-        .def_static("build", [](const std::string &expr_text) -> jmespath_expr_type {
-            return jmespath::make_expression<json>(expr_text);
+        .def_static("build", [](const std::string &expr_text) {
+            return ExpressionCache::instance().get(expr_text);
         }, "expr_text"_a, R"pbdoc(
             Create a new JMESPath expression.
         )pbdoc")
@@ -1,23 +1,37 @@
 from __future__ import annotations
 
 from ._core import (
+    Column,
     JMESPathExpr,
+    JMESPathResult,
     Json,
     JsonQuery,
     JsonQueryRepl,
     __doc__,
     __version__,
+    expression_cache_clear,
+    expression_cache_info,
+    expression_cache_resize,
     msgpack_decode,
     msgpack_encode,
+    parallel_projections_info,
+    set_parallel_projections,
 )
 
 __all__ = [
     "__doc__",
     "__version__",
+    "Column",
     "JsonQuery",
     "JsonQueryRepl",
     "JMESPathExpr",
+    "JMESPathResult",
     "Json",
+    "expression_cache_clear",
+    "expression_cache_info",
+    "expression_cache_resize",
     "msgpack_decode",
     "msgpack_encode",
+    "parallel_projections_info",
+    "set_parallel_projections",
 ]
@@ -7,16 +7,25 @@ Pybind11 bindings for jsoncons
 .. autosummary::
     :toctree: _generate
 
+    Column
     Json
     JsonQuery
     JsonQueryRepl
+    expression_cache_clear
+    expression_cache_info
+    expression_cache_resize
     msgpack_decode
     msgpack_encode
+    parallel_projections_info
+    set_parallel_projections
 """
 
 from __future__ import annotations
 
-from typing import Any, overload
+from mmap import mmap
+from typing import Any, Union, overload
+
+BytesLike = Union[bytes, bytearray, memoryview, mmap]
 
 __doc__: str
 __version__: str
@@ -49,12 +58,12 @@ class Json:
             str: JSON string representation
         """
 
-    def from_msgpack(self, msgpack_bytes: bytes) -> Json:
+    def from_msgpack(self, msgpack_bytes: BytesLike) -> Json:
         """
         Parse MessagePack binary data into a JSON object.
 
         Args:
-            msgpack_bytes: MessagePack binary data
+            msgpack_bytes: MessagePack binary data as any bytes-like object
 
         Returns:
             Json: Reference to self
@@ -154,6 +163,20 @@ class JsonQueryRepl:
             Json: Result of the evaluation as a json object
         """
 
+    def eval_expr_ref(self, expr: JMESPathExpr) -> JMESPathResult:
+        """
+        Evaluate a JMESPath expression against the JSON document without copying the result.
+
+        The result refers into doc, the parameters and the expression. It must not be used
+        after doc is modified or replaced, or add_params is called.
+
+        Args:
+            expr: JMESPath expression
+
+        Returns:
+            JMESPathResult: Result of the evaluation
+        """
+
     def add_params(self, key: str, value: str) -> None:
         """
         Add parameters for JMESPath evaluation.
@@ -163,12 +186,57 @@ class JsonQueryRepl:
             value: Parameter value as JSON string
         """
 
+class Column:
+    """
+    Typed buffer holding the results of one transform of a JsonQuery in columnar mode.
+
+    Numeric and bool columns expose their values through the buffer protocol,
+    string columns expose their UTF-8 bytes together with offsets().
+    """
+
+    @property
+    def kind(self) -> str:
+        """
+        Storage kind of the column: "empty", "int64", "float64", "bool", "string" or "json".
+        """
+
+    def __len__(self) -> int: ...
+    def __buffer__(self, flags: int) -> memoryview: ...
+    def validity(self) -> bytes:
+        """
+        Get the validity bitmap of the column.
+
+        Returns:
+            bytes: Bitmap with bit i (least significant bit first) set if row i is not null
+        """
+
+    def offsets(self) -> memoryview:
+        """
+        Get the offsets of a string column, row i spans bytes [offsets[i], offsets[i + 1]) of the buffer.
+
+        Returns:
+            memoryview: int64 view of a copy of the offsets
+        """
+
+    def to_python(self) -> list[Any]:
+        """
+        Convert the column to a Python list.
+
+        Returns:
+            list: Cell values, None for null cells
+        """
+
 class JsonQuery:
     """
     A class for filtering and transforming JSON data using JMESPath expressions.
     """
 
     debug: bool
+    columnar: bool
+    """
+    Columnar mode flag. When True, results are stored in one typed buffer per transform.
+    Changing it clears all processed data.
+    """
 
     def __init__(self) -> None:
         """
@@ -200,12 +268,12 @@ class JsonQuery:
             value: Parameter value as JSON string
         """
 
-    def matches(self, msgpack: bytes) -> bool:
+    def matches(self, msgpack: BytesLike) -> bool:
         """
         Check if a MessagePack message matches the predicate.
 
         Args:
-            msgpack: MessagePack data as bytes
+            msgpack: MessagePack data as any bytes-like object
 
         Returns:
             bool: True if the message matches, False otherwise
@@ -223,13 +291,13 @@ class JsonQuery:
         """
 
     def process(
-        self, msgpack: bytes, *, skip_predicate: bool = False, raise_error: bool = False
+        self, msgpack: BytesLike, *, skip_predicate: bool = False, raise_error: bool = False
     ) -> bool:
         """
         Process a MessagePack message with predicate matching and transformation.
 
         Args:
-            msgpack: MessagePack data as bytes
+            msgpack: MessagePack data as any bytes-like object
             skip_predicate: Whether to skip predicate matching (default: False)
             raise_error: Whether to raise errors during transformation (default: False)
 
@@ -237,6 +305,60 @@ class JsonQuery:
             bool: True if processing succeeded, False otherwise
         """
 
+    @overload
+    def process_batch(
+        self,
+        msgpacks: list[BytesLike],
+        *,
+        skip_predicate: bool = False,
+        raise_error: bool = False,
+        num_threads: int = 1,
+        keep_order: bool = True,
+    ) -> int:
+        """
+        Process a batch of MessagePack messages with predicate matching and transformation.
+
+        The GIL is released while the batch is processed. With more than one thread,
+        messages are evaluated concurrently and the rows are merged once the batch is done.
+
+        Args:
+            msgpacks: list of MessagePack data as bytes-like objects
+            skip_predicate: Whether to skip predicate matching (default: False)
+            raise_error: Whether to raise errors during transformation (default: False)
+            num_threads: Number of worker threads, 0 to use all hardware threads (default: 1)
+            keep_order: Whether rows keep the input order when using multiple threads (default: True)
+
+        Returns:
+            int: Number of messages that matched and were processed
+        """
+
+    @overload
+    def process_batch(
+        self,
+        buffer: BytesLike,
+        *,
+        skip_predicate: bool = False,
+        raise_error: bool = False,
+        num_threads: int = 1,
+        keep_order: bool = True,
+    ) -> int:
+        """
+        Process a buffer of length-prefixed MessagePack messages with predicate matching and transformation.
+
+        Each message is preceded by its size as a 4-byte big-endian unsigned integer.
+        The GIL is released while the batch is processed.
+
+        Args:
+            buffer: Concatenated length-prefixed MessagePack data as any bytes-like object
+            skip_predicate: Whether to skip predicate matching (default: False)
+            raise_error: Whether to raise errors during transformation (default: False)
+            num_threads: Number of worker threads, 0 to use all hardware threads (default: 1)
+            keep_order: Whether rows keep the input order when using multiple threads (default: True)
+
+        Returns:
+            int: Number of messages that matched and were processed
+        """
+
     def process_json(
         self, json: Json, *, skip_predicate: bool = False, raise_error: bool = False
     ) -> bool:
@@ -260,6 +382,37 @@ class JsonQuery:
             bytes: MessagePack binary data containing the processed results
         """
 
+    def export_chunk(self, max_rows: int) -> bytes:
+        """
+        Export up to max_rows of the oldest processed rows as MessagePack and drop them.
+
+        Args:
+            max_rows: Maximum number of rows to export
+
+        Returns:
+            bytes: MessagePack binary data containing the exported rows
+        """
+
+    def export_columns(self) -> bytes:
+        """
+        Export the processed data as a MessagePack map from each transform expression to its results.
+
+        Returns:
+            bytes: MessagePack binary data containing one array per transform
+        """
+
+    def column(self, index: int) -> Column:
+        """
+        Get the column buffer of a transform in columnar mode.
+
+        Args:
+            index: Transform index
+
+        Returns:
+            Column: Results of the transform
+        """
+
+    def __len__(self) -> int: ...
     def export_json(self) -> Json:
         """
         Export the processed data as JSON.
@@ -289,6 +442,30 @@ class JMESPathExpr:
             Json: Result of the evaluation
         """
 
+    def evaluate_ref(self, doc: Json) -> JMESPathResult:
+        """
+        Evaluate the JMESPath expression against a JSON document without copying the result.
+
+        The result refers into doc, which must not be modified while the result is in use.
+
+        Args:
+            doc: JSON document
+
+        Returns:
+            JMESPathResult: Result of the evaluation
+        """
+
+    def dump(self) -> str:
+        """
+        Describe the optimized plan of the expression, for debugging.
+
+        Constant subexpressions appear folded into literals. Each line is one step,
+        and the parts of nested expressions are indented further.
+
+        Returns:
+            str: The plan, one step per line
+        """
+
     @staticmethod
     def build(expr_text: str) -> JMESPathExpr:
         """
@@ -301,12 +478,91 @@ class JMESPathExpr:
             JMESPathExpr: Compiled JMESPath expression
         """
 
-def msgpack_decode(msgpack_bytes: bytes) -> str:
+class JMESPathResult:
+    """
+    The result of a JMESPath evaluation that refers into the evaluated document instead of
+    copying out of it.
+    """
+
+    def to_python(self) -> Any:
+        """
+        Convert the result to a Python object.
+
+        Returns:
+            Any: Python object representation of the result
+        """
+
+    def to_json(self) -> str:
+        """
+        Convert the result to a JSON string.
+
+        Returns:
+            str: JSON string representation
+        """
+
+    def to_msgpack(self) -> bytes:
+        """
+        Convert the result to MessagePack binary data.
+
+        Returns:
+            bytes: MessagePack binary data
+        """
+
+    def copy(self) -> Json:
+        """
+        Copy the result into an independent Json object.
+
+        Returns:
+            Json: Copy of the result
+        """
+
+def expression_cache_info() -> dict[str, int]:
+    """
+    Get the statistics of the compiled JMESPath expression cache, shared by JsonQueryRepl.eval,
+    JsonQuery and JMESPathExpr.build.
+
+    Returns:
+        dict: Hits, misses, number of cached expressions (size) and capacity
+    """
+
+def expression_cache_resize(capacity: int) -> None:
+    """
+    Set the maximum number of cached expressions, evicting the least recently used ones.
+
+    Args:
+        capacity: Maximum number of expressions, 0 disables caching
+    """
+
+def expression_cache_clear() -> None:
+    """
+    Drop all cached expressions and reset the statistics.
+    """
+
+def set_parallel_projections(num_threads: int, threshold: int = 100000) -> None:
+    """
+    Evaluate projections ([*], .*, slices and []) over large arrays and objects on several threads,
+    for JsonQueryRepl and JMESPathExpr evaluations. The elements are split into chunks whose
+    results are concatenated in order, so results do not change. Evaluation is serial by default.
+
+    Args:
+        num_threads: Number of threads, the evaluating one included, 0 to use all hardware threads, 1 for serial evaluation
+        threshold: Minimum number of elements of a projection evaluated in parallel (default: 100000)
+    """
+
+def parallel_projections_info() -> dict[str, int]:
+    """
+    Get the parallel projection settings.
+
+    Returns:
+        dict: Number of threads (num_threads, 1 if evaluation is serial) and threshold
+    """
+
+def msgpack_decode(msgpack_bytes: BytesLike) -> str:
     """
     Convert MessagePack binary data to a JSON string.
 
     Args:
-        msgpack_bytes: MessagePack binary data
+        msgpack_bytes: MessagePack binary data as any bytes-like object
 
     Returns:
         str: JSON string representation
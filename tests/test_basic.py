@@ -1,6 +1,11 @@
 from __future__ import annotations
 
 import json
+import math
+import random
+import struct
+import sys
+import threading
 
 import pytest
 
@@ -69,6 +74,154 @@ def test_repl():
     )
 
 
+def test_jmespath_result():
+    data = {"payload": {"items": [{"id": i, "tags": ["a", "b"]} for i in range(3)]}}
+    doc = m.Json().from_python(data)
+    expr = m.JMESPathExpr.build("payload.items")
+    result = expr.evaluate_ref(doc)
+    assert isinstance(result, m.JMESPathResult)
+    assert result.to_python() == data["payload"]["items"]
+    assert json.loads(result.to_json()) == data["payload"]["items"]
+    assert result.to_msgpack() == expr.evaluate(doc).to_msgpack()
+
+    expr = m.JMESPathExpr.build("reverse(sort_by(payload.items, &id))[*].{id: id, n: length(tags)}")
+    result = expr.evaluate_ref(doc)
+    copied = result.copy()
+    assert copied.to_python() == [{"id": i, "n": 2} for i in (2, 1, 0)]
+    del result, expr, doc
+    assert copied.to_python() == [{"id": i, "n": 2} for i in (2, 1, 0)]
+
+    repl = m.JsonQueryRepl(json.dumps(data))
+    repl.add_params("n", "2")
+    result = repl.eval_expr_ref(m.JMESPathExpr.build("payload.items[?id < $n].id"))
+    assert result.to_python() == [0, 1]
+
+    # replacing what a result refers into turns the result into a copy first
+    items = m.JMESPathExpr.build("payload.items")
+    results = [items.evaluate_ref(doc) for doc in [m.Json().from_python(data) for _ in range(3)]]
+    ref_doc = m.Json().from_python(data)
+    by_python, by_json, by_msgpack = (items.evaluate_ref(ref_doc) for _ in range(3))
+    ref_doc.from_python({"payload": None})
+    ref_doc.from_json('{"payload": 1}')
+    ref_doc.from_msgpack(m.msgpack_encode("[]"))
+    for result in [by_python, by_json, by_msgpack, *results]:
+        assert result.to_python() == data["payload"]["items"]
+    n = repl.eval_expr_ref(m.JMESPathExpr.build("$n"))
+    ids = repl.eval_expr_ref(m.JMESPathExpr.build("payload.items[*].id"))
+    tags = repl.eval_expr_ref(m.JMESPathExpr.build("payload.items[0].tags"))
+    repl.add_params("n", '"replaced"')
+    repl.doc = m.Json().from_json("{}")
+    repl.doc.from_json("[]")
+    assert n.to_python() == 2
+    assert ids.to_python() == [0, 1, 2]
+    assert tags.copy().to_python() == ["a", "b"]
+    assert repl.eval("[@, $n]") == '[[],"replaced"]'
+
+
+def test_expression_cache():
+    m.expression_cache_clear()
+    repl = m.JsonQueryRepl(json.dumps({"a": {"b": 1}}))
+    for _ in range(3):
+        assert repl.eval("a.b") == "1"
+    info = m.expression_cache_info()
+    assert (info["hits"], info["misses"], info["size"]) == (2, 1, 1)
+
+    expr = m.JMESPathExpr.build("a.b")
+    assert m.expression_cache_info()["hits"] == 3
+    assert m.JMESPathExpr.build("a.b") is expr
+
+    jql = m.JsonQuery()
+    jql.setup_predicate("a.b")
+    jql.add_params("x", "1")  # recompiled against the new parameter, a different entry
+    assert m.expression_cache_info()["size"] == 2
+
+    with pytest.raises(RuntimeError):
+        repl.eval("a.[")
+    assert m.expression_cache_info()["size"] == 2
+
+    m.expression_cache_resize(1)
+    info = m.expression_cache_info()
+    assert (info["size"], info["capacity"]) == (1, 1)
+    assert expr.evaluate(repl.doc).to_python() == 1
+    m.expression_cache_resize(256)
+    m.expression_cache_clear()
+    assert m.expression_cache_info()["misses"] == 0
+
+
+def test_parallel_projections():
+    doc = m.Json().from_python(
+        {
+            "items": [{"id": i, "tags": list(range(i % 3)), "v": i % 5 or None} for i in range(3000)],
+            "by_id": {str(i): {"id": i} for i in range(1500)},
+        }
+    )
+    exprs = [
+        "items[*].{id: id, n: length(tags)}",
+        "items[].tags[]",
+        "items[::-7].v",
+        "by_id.*.id",
+        "items[*].[id, v][?@ != `null`] | length(@)",
+    ]
+    expected = [m.JMESPathExpr.build(e).evaluate(doc).to_python() for e in exprs]
+    assert m.parallel_projections_info()["num_threads"] == 1
+    m.set_parallel_projections(4, threshold=100)
+    try:
+        assert m.parallel_projections_info() == {"num_threads": 4, "threshold": 100}
+        for e, value in zip(exprs, expected):
+            assert m.JMESPathExpr.build(e).evaluate(doc).to_python() == value
+            assert m.JMESPathExpr.build(e).evaluate_ref(doc).to_python() == value
+    finally:
+        m.set_parallel_projections(1)
+    assert m.parallel_projections_info()["num_threads"] == 1
+
+
+def test_jmespath_dump():
+    assert m.JMESPathExpr.build("length(`[1,2,3]`) > `2`").dump() == "literal true\n"
+    assert m.JMESPathExpr.build("`false` || a | @ | b").dump() == (
+        "current_node\nidentifier a\nidentifier b\n"
+    )
+    plan = m.JMESPathExpr.build("a[?b > to_number('5')].c").dump()
+    assert "    literal 5\n" in plan
+    assert "function" not in plan
+
+    doc = m.Json().from_python({"a": {"b": 7}})
+    assert m.JMESPathExpr.build("`true` || a.b").dump() == "literal true\n"
+    assert m.JMESPathExpr.build("`0` && a.b").evaluate(doc).to_python() == 7
+    # both operands are evaluated, folding a literal one must not hide an error of the other
+    for expr in ["`true` || abs('x')", "a.b || abs('x')", "`false` && abs('x')"]:
+        with pytest.raises(RuntimeError):
+            m.JMESPathExpr.build(expr).evaluate(doc)
+
+
+def test_jmespath_numeric_filter():
+    values = [0, 7, -3, 2.5, 100, 2**53 + 1, 2**64 - 1, "7", True, None, [], {"v": 1}]
+    items = [{"v": values[i % len(values)], "i": i} for i in range(600)]
+    items += [{"i": 600}, 5, None]
+    doc = m.Json().from_python({"items": items})
+
+    def truthy(x):
+        return x not in (None, False, "", [], {})
+
+    def cmp(a, op, b):
+        if not all(isinstance(x, (int, float)) and not isinstance(x, bool) for x in (a, b)):
+            return {"==": a == b, "!=": a != b}.get(op)
+        return {"==": a == b, "!=": a != b, "<": a < b, "<=": a <= b, ">": a > b, ">=": a >= b}[op]
+
+    for op in ["==", "!=", "<", "<=", ">", ">="]:
+        for lit in [7, 2.5, 2**53]:
+            expr = m.JMESPathExpr.build(f"items[?v {op} `{lit}` || `{lit}` {op} v && i > `300`].i")
+            expected = [
+                item["i"]
+                for item in items
+                if isinstance(item, dict)
+                and (
+                    truthy(cmp(item.get("v"), op, lit))
+                    or truthy(cmp(lit, op, item.get("v")) and item["i"] > 300)
+                )
+            ]
+            assert expr.evaluate(doc).to_python() == expected
+
+
 def test_msgpack():
     # https://msgpack.org/index.html
     data = m.msgpack_encode('{"compact":"true",         "schema":0}')
@@ -120,11 +273,329 @@ def test_json_query():
     data = m.msgpack_decode(export)
     assert json.loads(data) == [["Bob", 20], ["Fred", 25], ["George", 30]]
 
+    for p in people:
+        jql.process(m.msgpack_encode(json.dumps(p)))
+    assert json.loads(m.msgpack_decode(jql.export_chunk(2))) == [
+        ["Bob", 20],
+        ["Fred", 25],
+    ]
+    assert json.loads(m.msgpack_decode(jql.export_chunk(2))) == [
+        ["George", 30],
+        ["Bob", 20],
+    ]
+    assert json.loads(m.msgpack_decode(jql.export())) == [
+        ["Fred", 25],
+        ["George", 30],
+    ]
+    jql.clear()
+    assert json.loads(m.msgpack_decode(jql.export_chunk(2))) == []
+
     with pytest.raises(RuntimeError) as excinfo:
         jql.setup_transforms(["inval1d expr"])
     assert "Syntax error at" in repr(excinfo)
 
 
+def test_json_query_batch():
+    people = [
+        {"age": 5, "other": "too young", "name": "Baby"},
+        {"age": 20, "other": "foo", "name": "Bob"},
+        {"age": 25, "other": "bar", "name": "Fred"},
+        {"age": 30, "other": "baz", "name": "George"},
+    ]
+    msgs = [m.msgpack_encode(json.dumps(p)) for p in people]
+
+    jql = m.JsonQuery()
+    jql.setup_predicate("age >= `18`")
+    jql.setup_transforms(["name", "age"])
+    assert jql.process_batch(msgs) == 3
+    assert json.loads(m.msgpack_decode(jql.export())) == [
+        ["Bob", 20],
+        ["Fred", 25],
+        ["George", 30],
+    ]
+
+    jql = m.JsonQuery()
+    jql.setup_predicate("age >= `18`")
+    jql.setup_transforms(["name"])
+    packed = b"".join(len(msg).to_bytes(4, "big") + msg for msg in msgs)
+    assert jql.process_batch(packed) == 3
+    assert jql.process_batch(packed, skip_predicate=True) == 4
+    assert json.loads(m.msgpack_decode(jql.export())) == [
+        ["Bob"],
+        ["Fred"],
+        ["George"],
+        ["Baby"],
+        ["Bob"],
+        ["Fred"],
+        ["George"],
+    ]
+    with pytest.raises(RuntimeError) as excinfo:
+        jql.process_batch(packed[:-1])
+    assert "Truncated message" in repr(excinfo)
+
+    jql = m.JsonQuery()
+    jql.setup_predicate("age >= `18`")
+    jql.setup_transforms(["name"])
+    assert jql.matches(memoryview(msgs[1]))
+    assert not jql.matches(bytearray(msgs[0]))
+    assert jql.process(bytearray(msgs[1]))
+    assert jql.process_batch([memoryview(msg) for msg in msgs]) == 3
+    assert jql.process_batch(memoryview(packed)[: len(msgs[0]) + 4], skip_predicate=True) == 1
+    assert json.loads(m.msgpack_decode(jql.export())) == [
+        ["Bob"],
+        ["Bob"],
+        ["Fred"],
+        ["George"],
+        ["Baby"],
+    ]
+    assert m.Json().from_msgpack(memoryview(msgs[1])).to_python() == people[1]
+    assert json.loads(m.msgpack_decode(bytearray(msgs[1]))) == people[1]
+
+    msgs = msgs * 100
+    serial = m.JsonQuery()
+    serial.setup_predicate("age >= `18`")
+    serial.setup_transforms(["name", "age"])
+    assert serial.process_batch(msgs) == 300
+    parallel = m.JsonQuery()
+    parallel.setup_predicate("age >= `18`")
+    parallel.setup_transforms(["name", "age"])
+    assert parallel.process_batch(msgs, num_threads=4) == 300
+    assert parallel.export() == serial.export()
+    unordered = m.JsonQuery()
+    unordered.setup_predicate("age >= `18`")
+    unordered.setup_transforms(["name", "age"])
+    assert unordered.process_batch(msgs, num_threads=0, keep_order=False) == 300
+    assert sorted(json.loads(m.msgpack_decode(unordered.export()))) == sorted(
+        json.loads(m.msgpack_decode(serial.export()))
+    )
+
+
+def test_json_query_batch_errors():
+    msgs = [m.msgpack_encode(json.dumps({"v": -i})) for i in range(300)]
+    msgs[200] = m.msgpack_encode(json.dumps({"v": "x"}))
+    for num_threads in [1, 4]:
+        jql = m.JsonQuery()
+        jql.setup_transforms(["abs(v)"])
+        assert jql.process_batch(msgs[:100], skip_predicate=True, raise_error=True, num_threads=num_threads) == 100
+        # a failing message drops the whole batch, whether it ran on one thread or several
+        with pytest.raises(RuntimeError):
+            jql.process_batch(msgs, skip_predicate=True, raise_error=True, num_threads=num_threads)
+        assert len(jql) == 100
+        assert jql.process_batch(msgs, skip_predicate=True, num_threads=num_threads) == 300
+        assert len(jql) == 400
+        assert json.loads(m.msgpack_decode(jql.export()))[300] == [None]
+
+
+@pytest.mark.skipif(sys.version_info < (3, 12), reason="needs the __buffer__ protocol")
+def test_json_query_batch_busy():
+    started, resume = threading.Event(), threading.Event()
+
+    class BlockingBuffer:
+        # requested by the batch once it is busy; waits until the main thread has made its calls
+        def __init__(self, data):
+            self.data = data
+
+        def __buffer__(self, flags):
+            started.set()
+            assert resume.wait(timeout=10)
+            return memoryview(self.data)
+
+    msgs = [m.msgpack_encode(json.dumps({"i": i})) for i in range(100)]
+    jql = m.JsonQuery()
+    jql.setup_transforms(["i"])
+    packed = b"".join(len(x).to_bytes(4, "big") + x for x in msgs)
+    counts = []
+    for batch_input in [[BlockingBuffer(msgs[0]), *msgs[1:]], BlockingBuffer(packed)]:
+        started.clear()
+        resume.clear()
+        batch = threading.Thread(target=lambda b=batch_input: counts.append(jql.process_batch(b, skip_predicate=True)))
+        batch.start()
+        try:
+            assert started.wait(timeout=10)
+            for call in [lambda: len(jql), jql.export, lambda: jql.add_params("x", "1")]:
+                with pytest.raises(RuntimeError, match="busy"):
+                    call()
+        finally:
+            resume.set()
+            batch.join()
+    assert counts == [100, 100]
+    assert len(jql) == 200
+    jql.add_params("x", "1")
+
+
+def test_json_query_field_predicate():
+    docs = [
+        {"meta": {"kind": "a", "tags": [1, 2]}, "size": 2, "payload": "x" * 1000},
+        {"meta": {"kind": "b"}, "size": 5, "payload": list(range(100))},
+        {"meta": "a", "size": 3},
+        {"size": 9, "meta": {"kind": "a", "extra": {"deep": [None]}}},
+        [1, 2, 3],
+    ]
+    for predicate in [
+        "meta.kind == 'a' && size > `1`",
+        "meta.tags[0] == `1`",
+        "length(payload || '') > `10`",
+    ]:
+        jql = m.JsonQuery()
+        jql.setup_predicate(predicate)
+        jql.setup_transforms(["size"])
+        for doc in docs:
+            msg = m.msgpack_encode(json.dumps(doc))
+            assert jql.matches(msg) == jql.matches_json(m.Json().from_python(doc))
+            jql.process(msg)
+        assert json.loads(m.msgpack_decode(jql.export())) == [
+            [doc["size"]]
+            for doc in docs
+            if jql.matches_json(m.Json().from_python(doc))
+        ]
+
+
+def test_json_query_params():
+    docs = [{"age": age, "name": f"n{age}"} for age in range(10)]
+    jql = m.JsonQuery()
+    jql.add_params("low", "3")
+    jql.setup_predicate("age >= $low && age < $high")
+    jql.setup_transforms(["name", "let $low = `0` in [$low, $tag]"])
+    # declared after the expressions were set up
+    jql.add_params("high", "6")
+    jql.add_params("tag", json.dumps("x"))
+    for doc in docs:
+        jql.process(m.msgpack_encode(json.dumps(doc)))
+    assert json.loads(m.msgpack_decode(jql.export())) == [
+        [f"n{age}", [0, "x"]] for age in range(3, 6)
+    ]
+    jql.clear()
+    jql.add_params("low", "8")
+    jql.add_params("high", "100")
+    assert jql.process_batch([m.msgpack_encode(json.dumps(doc)) for doc in docs]) == 2
+
+
+def test_json_query_shared_prefixes():
+    docs = [
+        {"a": {"b": {"c": 5, "d": "xy"}}},
+        {"a": {"b": {"c": "long", "d": None}}},
+        {"a": {"b": 1}},
+        {"a": None},
+        [1, 2],
+    ]
+    transforms = [
+        "a.b.c",
+        "a.b.c",
+        "a.b",
+        "length(a.b.c)",
+        "a.b.d || a.b.c",
+        "a.b.c | @",
+        "a.missing.c",
+        "`1`",
+    ]
+    jql = m.JsonQuery()
+    jql.setup_predicate("a.b.c != `0`")
+    jql.setup_transforms(transforms)
+    for doc in docs:
+        jql.process(m.msgpack_encode(json.dumps(doc)))
+    rows = json.loads(m.msgpack_decode(jql.export()))
+    expected = []
+    for doc in docs:
+        j = m.Json().from_python(doc)
+        row = []
+        for t in transforms:
+            try:
+                row.append(m.JMESPathExpr.build(t).evaluate(j).to_python())
+            except Exception:
+                row.append(None)
+        expected.append(row)
+    assert rows == expected
+
+
+def test_json_query_wide_object():
+    doc = {f"key{i}": i for i in range(300)}
+    doc["key7"] = {"nested": {f"k{i}": -i for i in range(100)}}
+    jql = m.JsonQuery()
+    jql.setup_predicate("key299 == `299` && key7.nested.k99 == `-99`")
+    jql.setup_transforms(["key0", "key150", "key7.nested.k50", "missing"])
+    assert jql.process(m.msgpack_encode(json.dumps(doc)))
+    assert json.loads(m.msgpack_decode(jql.export())) == [[0, 150, -50, None]]
+    wide = m.Json().from_python(doc)
+    assert list(wide.to_python().keys()) == list(doc.keys())
+    expr = m.JMESPathExpr.build("merge(@, {key1: 'x', extra: `1`}).[key1, extra, key299]")
+    assert expr.evaluate(wide).to_python() == ["x", 1, 299]
+
+
+def test_json_query_columnar():
+    people = [
+        {"age": 20, "score": 1.5, "name": "Bob", "ok": True, "tags": ["a"]},
+        {"age": 25, "score": 2.5, "name": None, "ok": False, "tags": []},
+        {"age": 30, "score": 3.5, "name": "George", "ok": True, "tags": ["b"]},
+    ]
+    transforms = ["age", "score", "name", "ok", "tags", "missing"]
+    rows = m.JsonQuery()
+    rows.setup_transforms(transforms)
+    cols = m.JsonQuery()
+    cols.setup_transforms(transforms)
+    cols.columnar = True
+    for p in people:
+        msg = m.msgpack_encode(json.dumps(p))
+        assert rows.process(msg, skip_predicate=True)
+        assert cols.process(msg, skip_predicate=True)
+    assert len(cols) == 3
+    assert cols.export() == rows.export()
+    assert cols.export_json().to_json() == rows.export_json().to_json()
+    assert json.loads(m.msgpack_decode(cols.export_columns())) == {
+        "age": [20, 25, 30],
+        "score": [1.5, 2.5, 3.5],
+        "name": ["Bob", None, "George"],
+        "ok": [True, False, True],
+        "tags": [["a"], [], ["b"]],
+        "missing": [None, None, None],
+    }
+
+    assert [cols.column(i).kind for i in range(6)] == [
+        "int64",
+        "float64",
+        "string",
+        "bool",
+        "json",
+        "empty",
+    ]
+    assert memoryview(cols.column(0)).tolist() == [20, 25, 30]
+    assert memoryview(cols.column(1)).tolist() == [1.5, 2.5, 3.5]
+    assert memoryview(cols.column(3)).tolist() == [True, False, True]
+    name = cols.column(2)
+    assert bytes(memoryview(name)) == b"BobGeorge"
+    assert name.offsets().tolist() == [0, 3, 3, 9]
+    assert name.validity() == bytes([0b101])
+    assert name.to_python() == ["Bob", None, "George"]
+    with pytest.raises(RuntimeError):
+        memoryview(cols.column(4))
+
+    assert json.loads(m.msgpack_decode(cols.export_chunk(2))) == [
+        [20, 1.5, "Bob", True, ["a"], None],
+        [25, 2.5, None, False, [], None],
+    ]
+    assert len(cols) == 1
+    cols.columnar = False
+    assert len(cols) == 0
+    with pytest.raises(RuntimeError):
+        cols.column(0)
+
+    # columns are snapshots, buffers taken from them outlive later processing and clearing
+    cols.columnar = True
+    msg = m.msgpack_encode(json.dumps(people[0]))
+    assert cols.process(msg, skip_predicate=True)
+    ages = memoryview(cols.column(0))
+    name = cols.column(2)
+    for _ in range(1000):
+        assert cols.process(msg, skip_predicate=True)
+    assert memoryview(cols.column(0)).tolist() == [20] * 1001
+    assert ages.tolist() == [20]
+    assert len(cols.export_chunk(10)) > 0
+    cols.clear()
+    assert len(cols.column(0)) == 0
+    assert ages.tolist() == [20]
+    assert bytes(memoryview(name)) == b"Bob"
+    assert name.to_python() == ["Bob"]
+
+
 def test_json_type():
     obj = m.Json().from_json('{"compact":"true",         "schema":0}')
     assert obj.to_json() == '{"compact":"true","schema":0}'
@@ -144,6 +615,125 @@ def test_json_type():
     assert "Circular reference detected" in repr(excinfo)
 
 
+def test_json_numbers():
+    text = (
+        "[0, -0, 7, -12345678, 18446744073709551615, -9223372036854775808, "
+        "0.1, -2.5e-3, 1e23, 9007199254740993, 2.2250738585072011e-308, "
+        "4.9406564584124654e-324, 1.7976931348623157e308, 123456789012345678901234.5, "
+        "0.000000000000000000000000001234567890123456789, 7.2057594037927933e16]"
+    )
+    assert m.Json().from_json(text).to_python() == json.loads(text)
+
+
+def parse_corpus():
+    docs = [
+        '{"a": [1, -2.5e-3, 1e23, 18446744073709551616, true, false, null], "b": {"c": {}}, "d": []}',
+        '["caf\u00e9 \U0001f600", "\\"quoted\\"", "tab\\tnew\\nline", "\\u00e9\\ud83d\\ude00", "\\/"]',
+        " \t\r\n 42 \n",
+        '"top level string"',
+        "[" * 100 + "]" * 100,
+        '{"x": 1, "x": 2}',
+        "/* comment */ [1, // line comment\n 2]",
+        '{"a": 1 /* inside */, "b": [/**/]} // trailing',
+    ]
+    texts = [doc.encode() for doc in docs]
+    # every position of a special character around the 16, 32 and 64 byte blocks of the scanners
+    for length in range(140):
+        for special in ["\\n", '\\"', "\u00e9", "\\u0041", "\x01", "\x7f"]:
+            for pos in {0, length // 2, max(length - 1, 0)}:
+                text = "a" * pos + special + "a" * (length - pos)
+                texts.append(f'{{"k": "{text}", "{text}": [{length}]}}'.encode())
+    # invalid ones: truncated, bad escapes, bad UTF-8, bad numbers and misplaced separators
+    for doc in docs[:2]:
+        texts += [doc.encode()[:i] for i in range(len(doc.encode()))]
+    for pad in [0, 15, 31, 63, 64, 100]:
+        prefix = b'["' + b"x" * pad
+        texts += [prefix + bad + b'"]' for bad in [b"\\x", b"\\u12", b"\xff", b"\xc3", b"\xed\xa0\x80", b"\\ud800"]]
+        texts += [prefix + b'"' + bad for bad in [b",]", b"]]", b",", b":1]", b" 01]", b" 1.]", b" -]", b" 1e]"]]
+    return texts
+
+
+def test_json_structural_index():
+    for text in parse_corpus():
+        results = []
+        for structural_index in [False, True]:
+            try:
+                results.append(m.Json().from_json(text, structural_index=structural_index).to_json())
+            except RuntimeError as e:
+                results.append(("error", str(e)))
+        assert results[0] == results[1], text
+
+
+def test_json_in_situ():
+    for text in parse_corpus():
+        results = []
+        for parse in [lambda t: m.Json().from_json(t), m.Json.from_json_in_situ]:
+            try:
+                results.append(parse(text).to_json())
+            except RuntimeError as e:
+                results.append(("error", str(e)))
+        assert results[0] == results[1], text
+
+    # long strings refer to the parsed buffer, escaped ones are decoded in it
+    data = {
+        "plain": "p" * 40,
+        "escaped": 'say "hi"\n\ttab é \U0001f600 \\ ' * 3,
+        "items": [{"id": i, "name": "n" * 30 + str(i)} for i in range(4)],
+        "short": "abc",
+    }
+    text = json.dumps(data)
+    doc = m.Json.from_json_in_situ(text.encode())
+    assert doc.to_python() == data
+    assert doc.to_json() == m.Json().from_json(text).to_json()
+    assert doc.to_msgpack() == m.Json().from_python(data).to_msgpack()
+    assert m.Json().from_msgpack(doc.to_msgpack()).to_python() == data
+
+    name = "n" * 30 + "2"
+    assert m.JMESPathExpr.build(f'items[?name == `"{name}"`].id').evaluate(doc).to_python() == [2]
+    assert m.JMESPathExpr.build("items[0].name == items[0].name").evaluate(doc).to_python()
+    expr = m.JMESPathExpr.build("sort([plain, escaped, short, items[3].name])")
+    assert expr.evaluate(doc).to_python() == sorted([data["plain"], data["escaped"], "abc", "n" * 30 + "3"])
+
+    # copies own their strings, so they outlive the document and its buffer
+    copied = m.JMESPathExpr.build("[escaped, items]").evaluate(doc)
+    borrowed = m.JMESPathExpr.build("items[1]").evaluate_ref(doc)
+    repl = m.JsonQueryRepl("null")
+    repl.doc = doc
+    del doc
+    assert copied.to_python() == [data["escaped"], data["items"]]
+    assert borrowed.to_python() == data["items"][1]
+    assert repl.eval("plain") == json.dumps(data["plain"])
+    repl.doc = m.Json.from_json_in_situ(text)
+    assert json.loads(repl.eval("@")) == data
+
+
+def test_json_shortest_doubles():
+    values = [5.329070518200751e-15, 796809073182157.8, 1.7881393432617188e-07]
+    values += [0.1, 2.5, 1e-07, 1e22, 123456.789]
+    text = m.Json().from_python(values).to_json()
+    assert text == json.dumps(values, separators=(",", ":"))
+    assert json.loads(text) == values
+
+    # random bit patterns round-trip with as few significant digits as repr
+    rng = random.Random(20261018)
+    values = []
+    while len(values) < 2000:
+        (x,) = struct.unpack("<d", rng.getrandbits(64).to_bytes(8, "little"))
+        if math.isfinite(x):
+            values.append(x)
+    text = m.Json().from_python(values).to_json()
+    assert json.loads(text) == values
+    assert m.Json().from_json(text).to_python() == values
+
+    def digits(s):
+        return s.split("e")[0].replace("-", "").replace(".", "").strip("0")
+
+    for x in values:
+        text = m.Json().from_python(x).to_json()
+        assert float(text) == x
+        assert digits(text) == digits(repr(x)), (text, repr(x))
+
+
 def test_json_query_json():
     people = [
         {"age": 5, "other": "too young", "name": "Baby"},